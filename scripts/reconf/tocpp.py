@@ -66,10 +66,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ***********************************************/
 
-#include "satzilla_features.h"
+#include "features_to_reconf.h"
+#include <algorithm>
 #include <iostream>
 using std::cout;
 using std::endl;
+using std::vector;
+using std::pair;
+using std::make_pair;
 
 namespace CMSat {
 """)
@@ -79,28 +83,35 @@ for i in range(options.num):
         print("double get_score%d(const SatZillaFeatures& satzilla_feat, const int verb);" % i)
 
 print("""
-int get_reconf_from_satzilla_features(const SatZillaFeatures& satzilla_feat, const int verb)
+std::vector<int> get_reconf_ranking(const SatZillaFeatures& satzilla_feat, const int verb)
 {
-\tdouble best_score = 0.0;
-\tint best_val = 0;
-\tdouble score;
+\tvector<pair<double, int>> scores;
 """)
 
 for i in range(options.num):
     if i in ignore:
         continue
 
-    print("""
-\tscore = get_score%d(satzilla_feat, verb);
-\tif (verb >= 2)
-\t\tcout << "c Score for reconf %d is " << score << endl;
-\tif (best_score < score) {
-\t\tbest_score = score;
-\t\tbest_val = %d;
-\t}
-""" % (i, i, i))
+    print("""\tscores.push_back(make_pair(get_score%d(satzilla_feat, verb), %d));""" % (i, i))
 
 print("""
+\tstd::stable_sort(scores.begin(), scores.end(),
+\t\t[](const pair<double, int>& a, const pair<double, int>& b) {
+\t\t\treturn a.first > b.first;
+\t});
+
+\tvector<int> ranking;
+\tfor(const auto& s: scores) {
+\t\tif (verb >= 2)
+\t\t\tcout << "c Score for reconf " << s.second << " is " << s.first << endl;
+\t\tranking.push_back(s.second);
+\t}
+\treturn ranking;
+}
+
+int get_reconf_from_satzilla_features(const SatZillaFeatures& satzilla_feat, const int verb)
+{
+\tconst int best_val = get_reconf_ranking(satzilla_feat, verb)[0];
 \tif (verb >= 2)
 \t\tcout << "c Winning reconf is " << best_val << endl;
 \treturn best_val;
@@ -21,15 +21,156 @@ THE SOFTWARE.
 ***********************************************/
 
 #include "solver.h"
+#ifdef USE_CADIBACK
 #ifdef INSTALLED_CADIBACK
 #include <cadiback.h>
 #else
 #include "../cadiback/cadiback.h"
 #endif
+#endif
 
 using namespace CMSat;
 
+// Runs the CDCL search of this solver for at most max_confl conflicts,
+// under the single assumption "assump" (or none, if it's lit_Undef).
+// Learnt clauses are kept, so later calls get cheaper.
+lbool Solver::backbone_search(const Lit assump, const uint64_t max_confl)
+{
+    assert(decisionLevel() == 0);
+    assert(assumptions.empty());
+    conflict.clear();
+    if (assump != lit_Undef) {
+        assumptions.push_back(map_inter_to_outer(assump));
+        fill_assumptions_set();
+    }
+
+    const lbool ret = Searcher::solve(max_confl);
+    sumSearchStats += Searcher::get_stats();
+    sumPropStats += propStats;
+    propStats.clear();
+    Searcher::resetStats();
+
+    if (assump != lit_Undef) {
+        unfill_assumptions_set();
+        assumptions.clear();
+    }
+    return ret;
+}
+
+// Computes the backbone with the solver's own search engine. A SAT answer
+// removes all candidates it falsifies, an UNSAT answer under the assumption
+// ~lit makes lit a (learnt) top-level unit. Nothing is copied, and the
+// learnt clauses of each call are reused by the next one.
 bool Solver::backbone_simpl(int64_t orig_max_confl, bool& finished)
+{
+    finished = false;
+    if (!okay()) return false;
+#ifdef USE_CADIBACK
+    if (conf.backbone_use_cadiback) return backbone_simpl_cadiback(finished);
+#else
+    if (conf.backbone_use_cadiback) {
+        verb_print(1, "[backbone] not compiled with CadiBack, using our own search");
+    }
+#endif
+    if (nVars() == 0) return okay();
+    assert(decisionLevel() == 0);
+
+    const double my_time = cpuTime();
+    const uint64_t orig_sum_confl = sumConflicts;
+    const uint32_t orig_zero_set = trail.size();
+    uint32_t num_sat = 0;
+    uint32_t num_unsat = 0;
+
+    // Save state the user may still need, and the user's assumptions,
+    // in case we are called from inprocessing of a solve() with assumptions
+    const vector<lbool> saved_model = model;
+    const vector<Lit> saved_conflict = conflict;
+    const vector<Lit> saved_assumptions = assumptions;
+    const int saved_never_stop_search = conf.never_stop_search;
+    const bool order_heap_was_valid = !order_heap_vsids.empty();
+    unfill_assumptions_set();
+    assumptions.clear();
+    conf.never_stop_search = true; // no inprocessing inside the search
+    rebuildOrderHeap();
+
+    vector<Lit> cands;
+    auto budget_left = [&]() -> uint64_t {
+        const uint64_t used = sumConflicts - orig_sum_confl;
+        return (used >= (uint64_t)orig_max_confl) ? 0 : orig_max_confl - used;
+    };
+    auto filter_cands = [&]() {
+        uint32_t j = 0;
+        for(uint32_t i = 0; i < cands.size(); i++) {
+            const Lit l = cands[i];
+            if (value(l) == l_True) continue; // became a unit
+            if (model[l.var()] != boolToLBool(!l.sign())) continue;
+            cands[j++] = l;
+        }
+        cands.resize(j);
+    };
+
+    lbool ret = backbone_search(lit_Undef, budget_left());
+    if (ret == l_True) {
+        num_sat++;
+        // Start where the previous, budget-limited, call stopped, so
+        // repeated calls rotate over all variables. Candidates are
+        // checked from the back.
+        const uint32_t start = map_outer_to_inter(
+            std::min<uint32_t>(backbone_next_outer_var, nVarsOuter()-1)) % nVars();
+        for(uint32_t i = nVars(); i > 0; i--) {
+            const uint32_t v = (start+i-1) % nVars();
+            if (varData[v].removed != Removed::none || value(v) != l_Undef) continue;
+            if (model[v] == l_Undef) continue;
+            cands.push_back(Lit(v, model[v] == l_False));
+        }
+
+        while(!cands.empty()) {
+            const Lit l = cands.back();
+            if (value(l) == l_True) {cands.pop_back(); continue;}
+            assert(value(l) == l_Undef);
+            const uint64_t left = budget_left();
+            if (left == 0 || must_interrupt_asap() || cpuTime() > conf.maxTime) {
+                ret = l_Undef;
+                break;
+            }
+
+            ret = backbone_search(~l, left);
+            if (ret == l_True) {
+                // The model falsifies l, so this also removes l
+                num_sat++;
+                filter_cands();
+            } else if (ret == l_False) {
+                if (conflict.empty()) break; // UNSAT without assumptions
+                num_unsat++;
+                assert(value(l) == l_True);
+                cands.pop_back();
+            } else break;
+        }
+        finished = cands.empty();
+        backbone_next_outer_var = finished ? 0 : map_inter_to_outer(cands.back().var());
+    }
+    assert(okay() || (ret == l_False && conflict.empty()));
+
+    assumptions = saved_assumptions;
+    fill_assumptions_set();
+    conf.never_stop_search = saved_never_stop_search;
+    if (!order_heap_was_valid) clear_order_heap();
+    model = saved_model;
+    if (okay()) conflict = saved_conflict;
+
+    verb_print(1, "[backbone] finished: " << finished
+        << " new units: " << (trail.size()-orig_zero_set)
+        << " SAT calls: " << num_sat
+        << " UNSAT calls: " << num_unsat
+        << " remaining cands: " << cands.size()
+        << " confl: " << print_value_kilo_mega(sumConflicts - orig_sum_confl)
+        << " T: " << std::setprecision(2) << (cpuTime()-my_time));
+
+    return okay();
+}
+
+#ifdef USE_CADIBACK
+bool Solver::backbone_simpl_cadiback(bool& finished)
 {
     vector<int> cnf;
     /* for(uint32_t i = 0; i < nVars(); i++) picosat_inc_max_var(picosat); */
@@ -70,6 +211,7 @@ bool Solver::backbone_simpl(int64_t orig_max_confl, bool& finished)
     }
     return sat != 20;
 }
+#endif
 
 void Solver::detach_and_free_all_irred_cls()
 {
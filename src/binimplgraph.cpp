@@ -0,0 +1,97 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "binimplgraph.h"
+#include "solver.h"
+
+using namespace CMSat;
+
+uint64_t BinImplGraph::build(const Solver* solver)
+{
+    const uint32_t n = solver->nVars()*2;
+    uint64_t scanned = 0;
+    offs.clear();
+    offs.resize(n+1, 0);
+    red_offs.clear();
+    red_offs.resize(n, 0);
+
+    //Count irred and red successors of each node
+    for(uint32_t node = 0; node < n; node++) {
+        const Lit lit = Lit::toLit(node);
+        if (solver->value(lit) != l_Undef) {
+            //Assigned nodes get an empty range
+            offs[node+1] = offs[node];
+            red_offs[node] = offs[node];
+            continue;
+        }
+        watch_subarray_const ws = solver->watches[~lit];
+        scanned += ws.size();
+        uint32_t irred = 0;
+        uint32_t red = 0;
+        for(const Watched& w: ws) {
+            if (!w.isBin() || solver->value(w.lit2()) != l_Undef) continue;
+            if (w.red()) red++;
+            else irred++;
+        }
+        offs[node+1] = offs[node] + irred + red;
+        red_offs[node] = offs[node] + irred;
+    }
+    if (n == 0) return scanned;
+
+    //Fill, irred from the front, red from the middle of each range
+    edges.clear();
+    edges.resize(offs[n]);
+    vector<uint32_t> at_irred(offs.begin(), offs.end()-1);
+    vector<uint32_t> at_red(red_offs);
+    for(uint32_t node = 0; node < n; node++) {
+        const Lit lit = Lit::toLit(node);
+        if (solver->value(lit) != l_Undef) continue;
+        for(const Watched& w: solver->watches[~lit]) {
+            if (!w.isBin() || solver->value(w.lit2()) != l_Undef) continue;
+            if (w.red()) edges[at_red[node]++] = w.lit2().toInt();
+            else edges[at_irred[node]++] = w.lit2().toInt();
+        }
+        assert(at_irred[node] == red_offs[node]);
+        assert(at_red[node] == offs[node+1]);
+    }
+
+    return scanned;
+}
+
+void BinImplGraph::clear()
+{
+    offs.clear();
+    offs.shrink_to_fit();
+    red_offs.clear();
+    red_offs.shrink_to_fit();
+    edges.clear();
+    edges.shrink_to_fit();
+}
+
+size_t BinImplGraph::mem_used() const
+{
+    size_t mem = 0;
+    mem += offs.capacity()*sizeof(uint32_t);
+    mem += red_offs.capacity()*sizeof(uint32_t);
+    mem += edges.capacity()*sizeof(uint32_t);
+    return mem;
+}
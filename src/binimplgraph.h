@@ -0,0 +1,77 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef BINIMPLGRAPH_H
+#define BINIMPLGRAPH_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+using std::vector;
+
+namespace CMSat {
+
+class Solver;
+
+// Read-only snapshot of the binary implication graph in CSR form: the
+// successors of literal L are all x with (~L V x) a binary clause. Only
+// unassigned literals are kept. Per node the irredundant edges come first,
+// followed by the redundant ones.
+//
+// Building it costs two passes over the watchlists, so it only pays off for
+// walks that visit nodes many times, such as the bit-parallel prober in
+// probe.cpp. A single DFS, as in SCCFinder, is better off on the watches.
+class BinImplGraph {
+public:
+    // Returns the number of watches scanned, for bogoprops accounting
+    uint64_t build(const Solver* solver);
+    void clear();
+
+    const uint32_t* begin(const uint32_t node) const {
+        return edges.data() + offs[node];
+    }
+    const uint32_t* irred_end(const uint32_t node) const {
+        return edges.data() + red_offs[node];
+    }
+    const uint32_t* end(const uint32_t node) const {
+        return edges.data() + offs[node+1];
+    }
+    uint32_t num_succ(const uint32_t node) const {
+        return offs[node+1] - offs[node];
+    }
+    uint32_t num_nodes() const {
+        return offs.empty() ? 0 : offs.size()-1;
+    }
+    uint64_t num_edges() const { return edges.size(); }
+    size_t mem_used() const;
+
+private:
+    vector<uint32_t> offs; //node -> first edge, size num_nodes+1
+    vector<uint32_t> red_offs; //node -> first redundant edge
+    vector<uint32_t> edges; //Lit::toInt() of successor
+};
+
+}
+
+#endif //BINIMPLGRAPH_H
@@ -0,0 +1,97 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+using std::vector;
+
+// Sorted clause encoding, shared by ElimedClsStore and the binary CNF format
+// of CNFWriter. The literals are sorted and each one is stored as the varint
+// of its delta to the previous literal plus one, so a zero byte ends the
+// clause. A varint holds 7 bits per byte, lowest first, and the high bit is
+// set on all but its last byte.
+
+//A literal's delta+1 is below 2^30
+static const size_t max_enc_lit_bytes = 5;
+
+inline uint8_t* varint_put(uint64_t v, uint8_t* out)
+{
+    while(v >= 0x80) {
+        *out++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = (uint8_t)v;
+    return out;
+}
+
+//Returns false if the varint runs over end or is too long
+inline bool varint_get(const uint8_t*& p, const uint8_t* const end, uint64_t& v)
+{
+    v = 0;
+    uint32_t shift = 0;
+    do {
+        if (p == end || shift > 63) return false;
+        v |= (uint64_t)(*p & 0x7f) << shift;
+        shift += 7;
+    } while(*p++ & 0x80);
+    return true;
+}
+
+//Sorts lits and writes them with the terminating zero. "out" must have room
+//for (lits.size()+1)*max_enc_lit_bytes bytes. Returns the new end
+inline uint8_t* put_sorted_clause(vector<Lit>& lits, uint8_t* out)
+{
+    std::sort(lits.begin(), lits.end());
+    uint32_t prev = 0;
+    for(const Lit l: lits) {
+        out = varint_put((uint64_t)(l.toInt() - prev) + 1, out);
+        prev = l.toInt();
+    }
+    *out++ = 0;
+    return out;
+}
+
+//Reads one clause into lits. Returns false if it's malformed or runs over end
+inline bool get_sorted_clause(const uint8_t*& p, const uint8_t* const end, vector<Lit>& lits)
+{
+    lits.clear();
+    uint64_t prev = 0;
+    while(true) {
+        uint64_t v;
+        if (!varint_get(p, end, v)) return false;
+        if (v == 0) return true;
+        prev += v - 1;
+        if (prev >= 2ULL*(var_Undef)) return false;
+        lits.push_back(Lit::toLit((uint32_t)prev));
+    }
+}
+
+}
@@ -57,12 +57,18 @@ using std::endl;
 #define ALLOC_GROW_MULT 1.5
 
 #define MAXSIZE ((1ULL << (EFFECTIVELY_USEABLE_BITS))-1)
+#ifdef LARGE_OFFSETS
+#define MAX_OFFSET_SHIFT 0
+#else
+#define MAX_OFFSET_SHIFT 4
+#endif
 
 ClauseAllocator::ClauseAllocator() :
     dataStart(nullptr)
     , size(0)
     , capacity(0)
     , currentlyUsedSize(0)
+    , max_unshifted(MAXSIZE)
 {
     assert(MIN_LIST_SIZE < MAXSIZE);
 }
@@ -75,6 +81,18 @@ ClauseAllocator::~ClauseAllocator()
     free(dataStart);
 }
 
+//The number of BASE_DATA_TYPE datapieces addressable with the current shift
+uint64_t ClauseAllocator::max_size() const
+{
+    return max_unshifted << offset_shift;
+}
+
+uint64_t ClauseAllocator::aligned(const uint64_t sz, const uint32_t shift) const
+{
+    const uint64_t mask = (1ULL << shift) - 1;
+    return (sz + mask) & ~mask;
+}
+
 void* ClauseAllocator::allocEnough(
     uint32_t num_lits
 ) {
@@ -82,6 +100,7 @@ void* ClauseAllocator::allocEnough(
     uint64_t neededbytes = sizeof(Clause) + sizeof(Lit)*num_lits;
     uint64_t needed
         = neededbytes/sizeof(BASE_DATA_TYPE) + (bool)(neededbytes % sizeof(BASE_DATA_TYPE));
+    needed = aligned(needed, offset_shift);
 
     if (size + needed > capacity) {
         //Grow by default, but don't go under or over the limits
@@ -91,27 +110,30 @@ void* ClauseAllocator::allocEnough(
             newcapacity *= ALLOC_GROW_MULT;
         }
         assert(newcapacity >= size+needed);
-        newcapacity = std::min<size_t>(newcapacity, MAXSIZE);
+        newcapacity = std::min<size_t>(newcapacity, max_size());
 
-        //Oops, not enough space anyway
+        //Oops, not enough space anyway. The offset shift is only raised at
+        //consolidation, so the stack must have doubled since the last one
         if (newcapacity < size + needed) {
             std::cerr
             << "ERROR: memory manager can't handle the load."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+            << (offset_shift == MAX_OFFSET_SHIFT ? " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**" : "")
 #endif
             << " size: " << size
             << " needed: " << needed
             << " newcapacity: " << newcapacity
+            << " offset shift: " << offset_shift
             << endl;
             std::cout
             << "ERROR: memory manager can't handle the load."
 #ifndef LARGE_OFFSETS
-            << " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**"
+            << (offset_shift == MAX_OFFSET_SHIFT ? " **PLEASE RECOMPILE WITH -DLARGEMEM=ON**" : "")
 #endif
             << " size: " << size
             << " needed: " << needed
             << " newcapacity: " << newcapacity
+            << " offset shift: " << offset_shift
             << endl;
 
             throw std::bad_alloc();
@@ -157,7 +179,9 @@ rerturns a 32-bit value that is a concatenation of these two
 */
 ClOffset ClauseAllocator::get_offset(const Clause* ptr) const
 {
-    return ((BASE_DATA_TYPE*)ptr - dataStart);
+    const uint64_t at = (BASE_DATA_TYPE*)ptr - dataStart;
+    assert(aligned(at, offset_shift) == at);
+    return at >> offset_shift;
 }
 
 /**
@@ -181,6 +205,7 @@ void ClauseAllocator::clauseFree(Clause* cl)
     est_num_cl = std::max(est_num_cl, (uint64_t)3); //we sometimes allow gauss to allocate 3-long clauses
     uint64_t bytes_freed = sizeof(Clause) + est_num_cl*sizeof(Lit);
     uint64_t elems_freed = bytes_freed/sizeof(BASE_DATA_TYPE) + (bool)(bytes_freed % sizeof(BASE_DATA_TYPE));
+    elems_freed = aligned(elems_freed, offset_shift);
     currentlyUsedSize -= elems_freed;
 
     #ifdef VALGRIND_MAKE_MEM_UNDEFINED
@@ -202,8 +227,9 @@ ClOffset ClauseAllocator::move_cl(
     uint64_t bytesNeeded = sizeof(Clause) + old->size()*sizeof(Lit);
     uint64_t sizeNeeded = bytesNeeded/sizeof(BASE_DATA_TYPE) + (bool)(bytesNeeded % sizeof(BASE_DATA_TYPE));
     memcpy(new_ptr, old, sizeNeeded*sizeof(BASE_DATA_TYPE));
+    sizeNeeded = aligned(sizeNeeded, new_shift_while_moving);
 
-    ClOffset new_offset = new_ptr-newDataStart;
+    ClOffset new_offset = (new_ptr-newDataStart) >> new_shift_while_moving;
     (*old)[0] = Lit::toLit(new_offset & 0xFFFFFFFF);
     #ifdef LARGE_OFFSETS
     (*old)[1] = Lit::toLit((new_offset>>32) & 0xFFFFFFFF);
@@ -255,7 +281,9 @@ void ClauseAllocator::consolidate(
     //1) There is too much memory allocated. Re-allocation will save space
     //   Avoiding segfault (max is 16 outerOffsets, more than 10 is near)
     //2) There is too much empty, unused space (>30%)
-    if (!force
+    //3) The offset shift must be raised as we are nearing the addressable size
+    const bool must_shift = offset_shift < MAX_OFFSET_SHIFT && size*2 > max_size();
+    if (!force && !must_shift
         && (float_div(currentlyUsedSize, size) > 0.8 || currentlyUsedSize < (100ULL*1000ULL))
     ) {
         if (solver->conf.verbosity >= 3
@@ -268,8 +296,29 @@ void ClauseAllocator::consolidate(
     const double my_time = cpuTime();
     new_sz_while_moving = 0;
 
+    //Raise the offset shift when nearing the addressable size, lower it
+    //when far below it, so small instances waste no space on alignment
+    new_shift_while_moving = offset_shift;
+    while (new_shift_while_moving < MAX_OFFSET_SHIFT
+        && currentlyUsedSize*2 > (max_unshifted << new_shift_while_moving)
+    ) {
+        new_shift_while_moving++;
+    }
+    while (new_shift_while_moving > 0
+        && currentlyUsedSize*8 < (max_unshifted << (new_shift_while_moving-1))
+    ) {
+        new_shift_while_moving--;
+    }
+
+    //Every clause may need padding up to the new alignment
+    uint64_t new_capacity = currentlyUsedSize;
+    if (new_shift_while_moving > offset_shift) {
+        const uint64_t min_cl_size = sizeof(Clause)/sizeof(BASE_DATA_TYPE);
+        new_capacity += (currentlyUsedSize/min_cl_size + 1)*((1ULL << new_shift_while_moving) - 1);
+    }
+
     //Pointers that will be moved along
-    BASE_DATA_TYPE * const newDataStart = (BASE_DATA_TYPE*)malloc(currentlyUsedSize*sizeof(BASE_DATA_TYPE));
+    BASE_DATA_TYPE * const newDataStart = (BASE_DATA_TYPE*)malloc(new_capacity*sizeof(BASE_DATA_TYPE));
     BASE_DATA_TYPE * new_ptr = newDataStart;
 
     assert(sizeof(BASE_DATA_TYPE) % sizeof(Lit) == 0);
@@ -309,10 +358,12 @@ void ClauseAllocator::consolidate(
     //Update sizes
     const uint64_t old_size = size;
     size = new_ptr-newDataStart;
-    capacity = currentlyUsedSize;
+    capacity = new_capacity;
     currentlyUsedSize = new_sz_while_moving;
     free(dataStart);
     dataStart = newDataStart;
+    const uint32_t old_shift = offset_shift;
+    offset_shift = new_shift_while_moving;
 
     const double time_used = cpuTime() - my_time;
     if (solver->conf.verbosity >= 2
@@ -327,6 +378,7 @@ void ClauseAllocator::consolidate(
         cout << " old-sz: " << print_value_kilo_mega(old_size*sizeof(BASE_DATA_TYPE))
         << " new-sz: " << print_value_kilo_mega(size*sizeof(BASE_DATA_TYPE))
         << " new bits offs: " << std::fixed << std::setprecision(2) << log_2_size;
+        if (old_shift != offset_shift) cout << " offset shift: " << old_shift << " -> " << offset_shift;
         cout << solver->conf.print_times(time_used)
         << endl;
     }
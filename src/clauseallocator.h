@@ -34,6 +34,10 @@ THE SOFTWARE.
 #include <map>
 #include <vector>
 
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
 namespace CMSat {
 
 class Clause;
@@ -51,6 +55,11 @@ needed. When instructed, it consolidates the unused space (i.e. clauses free()-e
 Essentially, it is a stack-like allocator for clauses. It is useful to have
 this, because this way, we can address clauses according to their number,
 which is 32-bit, instead of their address, which might be 64-bit
+
+Offsets are scaled: clauses start at multiples of 2^offset_shift datapieces,
+and the offset is the position shifted down by offset_shift. The shift starts
+at 0 and is raised at consolidation when the stack nears what the offset bits
+can address, so the watches stay 8 bytes even for stacks of tens of GB.
 */
 class ClauseAllocator {
     public:
@@ -73,7 +82,7 @@ class ClauseAllocator {
 
         inline Clause* ptr(const ClOffset offset) const
         {
-            return (Clause*)(&dataStart[offset]);
+            return (Clause*)(&dataStart[(uint64_t)offset << offset_shift]);
         }
 
         void clauseFree(Clause* c);
@@ -86,6 +95,7 @@ class ClauseAllocator {
         );
 
         size_t mem_used() const;
+        uint32_t get_offset_shift() const { return offset_shift; }
 
     private:
         void update_offsets(
@@ -102,7 +112,11 @@ class ClauseAllocator {
             , Clause* old
         );
 
-        uint32_t new_sz_while_moving;
+        uint64_t new_sz_while_moving;
+        uint32_t new_shift_while_moving;
+        uint32_t offset_shift = 0;
+        uint64_t max_size() const;
+        uint64_t aligned(const uint64_t sz, const uint32_t shift) const;
         BASE_DATA_TYPE* dataStart; ///<Stack starts at these positions
         uint64_t size; ///<The number of BASE_DATA_TYPE datapieces currently used in each stack
         /**
@@ -121,6 +135,12 @@ class ClauseAllocator {
         */
         uint64_t currentlyUsedSize;
 
+        ///The number of BASE_DATA_TYPE datapieces the offsets address unshifted
+        uint64_t max_unshifted;
+        #ifdef CMS_TESTING_ENABLED
+        FRIEND_TEST(SolverTest, clause_offset_shift_raised_and_lowered);
+        #endif
+
         void* allocEnough(const uint32_t num_lits);
 };
 
@@ -160,8 +160,13 @@ bool ClauseCleaner::clean_bnn(BNN& bnn, uint32_t bnn_idx) {
         removeWBNN(solver->watches, bnn.out, bnn_idx);
         removeWBNN(solver->watches, ~bnn.out, bnn_idx);
         if (solver->value(bnn.out) == l_False) {
+            //The watches of a literal carry its polarity, flip them too
             for (auto& l: bnn) {
+                removeWBNN(solver->watches, l, bnn_idx);
+                removeWBNN(solver->watches, ~l, bnn_idx);
                 l = ~l;
+                solver->watches[l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_pos_t));
+                solver->watches[~l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_neg_t));
             }
             bnn.cutoff = (int32_t)bnn.size()+1-bnn.cutoff;
         }
@@ -32,8 +32,14 @@ THE SOFTWARE.
 #include "sqlstats.h"
 #include "completedetachreattacher.h"
 
+#include <mutex>
+
 using namespace CMSat;
 
+//BreakID (bliss in particular) has static state, so only one instance
+//may run at a time in the whole process
+static std::mutex breakid_lib_mutex;
+
 BreakID::BreakID(Solver* _solver):
     solver(_solver)
 {
@@ -211,6 +217,7 @@ bool BreakID::doit()
 
     if (!check_limits()) return solver->okay();
     if (!solver->clauseCleaner->remove_and_clean_all()) return solver->okay();
+    std::lock_guard<std::mutex> lib_lock(breakid_lib_mutex);
 
     // Clean up solver state so it's easier to find symmetries
     solver->subsumeImplicit->subsume_implicit(false, "-breakid");
@@ -246,7 +246,12 @@ void CNF::update_vars(
 
     updateBySwap(watches, seen, inter_to_outer2);
     updateBySwap(gwatches, seen, inter_to_outer);
-    for(watch_subarray w: watches) if (!w.empty()) update_watch(w, outer_to_inter);
+    update_in_chunks(watches.size(), conf.renumber_threads, [&](size_t from, size_t to) {
+        for(size_t i = from; i < to; i++) {
+            watch_subarray w = watches[Lit::toLit(i)];
+            if (!w.empty()) update_watch(w, outer_to_inter);
+        }
+    });
     updateArray(inter_to_outerMain, inter_to_outer);
 
     updateArrayMapCopy(outer_to_interMain, outer_to_inter);
@@ -0,0 +1,123 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "solvertypesmini.h"
+#include "clause_enc.h"
+
+namespace CMSat {
+
+using std::vector;
+
+// Reads the binary CNF format written by CNFWriter (see cnfwriter.h) into a
+// solver with the SATSolver interface. XORs are added with their rhs folded
+// into the literals, like the "x" lines of DIMACS
+template <class S>
+class CNFBinReader
+{
+public:
+    explicit CNFBinReader(S* _solver) : solver(_solver) {}
+
+    //True if the file starts with the magic of the format
+    static bool is_binary_cnf(const std::string& fname);
+
+    //Returns false and prints the reason if the file can't be read
+    bool parse(const std::string& fname);
+
+    uint64_t num_cls = 0;
+    uint32_t num_vars = 0;
+
+private:
+    S* solver;
+    bool error(const std::string& fname, const std::string& what) const;
+};
+
+template <class S>
+bool CNFBinReader<S>::is_binary_cnf(const std::string& fname)
+{
+    FILE* f = fopen(fname.c_str(), "rb");
+    if (!f) return false;
+    char magic[4];
+    const bool ret = fread(magic, 1, 4, f) == 4 && memcmp(magic, "CMSB", 4) == 0;
+    fclose(f);
+    return ret;
+}
+
+template <class S>
+bool CNFBinReader<S>::error(const std::string& fname, const std::string& what) const
+{
+    std::cerr << "PARSE ERROR! Binary CNF file '" << fname << "': " << what << std::endl;
+    return false;
+}
+
+template <class S>
+bool CNFBinReader<S>::parse(const std::string& fname)
+{
+    FILE* f = fopen(fname.c_str(), "rb");
+    if (!f) return error(fname, "cannot open file");
+    vector<uint8_t> data;
+    uint8_t chunk[1 << 16];
+    size_t n;
+    while((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk+n);
+    const bool read_ok = !ferror(f);
+    fclose(f);
+    if (!read_ok) return error(fname, "read failed");
+
+    const size_t header_bytes = 4+4+8;
+    if (data.size() < header_bytes || memcmp(data.data(), "CMSB", 4) != 0) {
+        return error(fname, "missing header");
+    }
+    num_vars = 0;
+    for(uint32_t i = 0; i < 4; i++) num_vars |= (uint32_t)data[4+i] << (8*i);
+    uint64_t header_cls = 0;
+    for(uint32_t i = 0; i < 8; i++) header_cls |= (uint64_t)data[8+i] << (8*i);
+    if (num_vars > solver->nVars()) solver->new_vars(num_vars - solver->nVars());
+
+    const uint8_t* p = data.data() + header_bytes;
+    const uint8_t* const end = data.data() + data.size();
+    vector<Lit> lits;
+    num_cls = 0;
+    while(p != end) {
+        const uint8_t type = *p++;
+        if (type != 'a' && type != 'x') return error(fname, "unknown constraint type");
+        if (!get_sorted_clause(p, end, lits)) return error(fname, "malformed literals");
+        for(const Lit l: lits) {
+            if (l.var() >= num_vars) return error(fname, "variable over the header's count");
+        }
+        if (type == 'a') solver->add_clause(lits);
+        else solver->add_xor_clause(lits, true);
+        num_cls++;
+    }
+    if (num_cls != header_cls) return error(fname, "constraint count differs from the header");
+    return true;
+}
+
+}
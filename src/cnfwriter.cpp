@@ -0,0 +1,128 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "cnfwriter.h"
+#include "clause_enc.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace CMSat;
+
+//Upper bound on the bytes a literal takes in either format
+static const size_t max_lit_bytes = 12;
+static const size_t buf_size = 16ULL*1024ULL*1024ULL;
+
+CNFWriter::~CNFWriter()
+{
+    if (f) fclose(f);
+}
+
+bool CNFWriter::open(const std::string& fname)
+{
+    f = fopen(fname.c_str(), "wb");
+    if (!f) return false;
+    buf.resize(buf_size);
+    buf_at = 0;
+    write_header();
+    return true;
+}
+
+// Fixed width in both formats, so it can be overwritten in place
+void CNFWriter::write_header()
+{
+    if (fmt == Format::dimacs) {
+        char line[64];
+        const int n = snprintf(line, sizeof(line), "p cnf %-10u %-20llu\n",
+            num_vars, (unsigned long long)num_cls);
+        memcpy(buf.data()+buf_at, line, n);
+        buf_at += n;
+    } else {
+        memcpy(buf.data()+buf_at, "CMSB", 4);
+        buf_at += 4;
+        for(uint32_t i = 0; i < 4; i++) put_char((char)(num_vars >> (8*i)));
+        for(uint32_t i = 0; i < 8; i++) put_char((char)(num_cls >> (8*i)));
+    }
+}
+
+void CNFWriter::flush()
+{
+    if (buf_at == 0) return;
+    if (fwrite(buf.data(), 1, buf_at, f) != buf_at) failed = true;
+    buf_at = 0;
+}
+
+void CNFWriter::put_uint(uint64_t v)
+{
+    char tmp[20];
+    uint32_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while(v != 0);
+    while(n > 0) put_char(tmp[--n]);
+}
+
+void CNFWriter::add(vector<Lit>& lits, const bool is_xor, const bool rhs)
+{
+    num_cls++;
+    if (is_xor && !rhs) {
+        assert(!lits.empty());
+        lits[0] ^= true;
+    }
+    for(const Lit l: lits) num_vars = std::max(num_vars, l.var()+1);
+
+    if (buf.size() - buf_at < (lits.size()+2)*max_lit_bytes) {
+        flush();
+        if (buf.size() < (lits.size()+2)*max_lit_bytes) buf.resize((lits.size()+2)*max_lit_bytes);
+    }
+
+    if (fmt == Format::dimacs) {
+        if (is_xor) {put_char('x'); put_char(' ');}
+        for(const Lit l: lits) {
+            if (l.sign()) put_char('-');
+            put_uint(l.var()+1);
+            put_char(' ');
+        }
+        put_char('0');
+        put_char('\n');
+    } else {
+        put_char(is_xor ? 'x' : 'a');
+        uint8_t* const at = reinterpret_cast<uint8_t*>(buf.data() + buf_at);
+        buf_at += put_sorted_clause(lits, at) - at;
+    }
+}
+
+bool CNFWriter::close()
+{
+    if (!f) return false;
+    flush();
+    if (fseek(f, 0, SEEK_SET) != 0) failed = true;
+    else {
+        write_header();
+        flush();
+    }
+    if (fclose(f) != 0) failed = true;
+    f = nullptr;
+    return !failed;
+}
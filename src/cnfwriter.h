@@ -0,0 +1,75 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+using std::vector;
+
+// Single-pass writer of a CNF with XORs. The header is written as a
+// fixed-width placeholder and patched on close(), so the constraints don't
+// have to be counted beforehand. Two formats:
+// * DIMACS, with "x" lines for XORs, rhs folded into the first literal
+// * binary: magic "CMSB", uint32 number of vars and uint64 number of
+//   constraints (little endian), then each constraint as a type byte ('a' for
+//   clause, 'x' for XOR with rhs folded as above), then its literals in the
+//   sorted clause encoding of clause_enc.h. CNFBinReader reads it back
+class CNFWriter
+{
+public:
+    enum class Format {dimacs, binary};
+    explicit CNFWriter(const Format _fmt) : fmt(_fmt) {}
+    ~CNFWriter();
+    CNFWriter(const CNFWriter&) = delete;
+    CNFWriter& operator=(const CNFWriter&) = delete;
+
+    bool open(const std::string& fname);
+    void add(vector<Lit>& lits, const bool is_xor, const bool rhs);
+    //Returns false if any write failed
+    bool close();
+
+    uint64_t num_cls = 0;
+    uint32_t num_vars = 0;
+
+private:
+    const Format fmt;
+    FILE* f = nullptr;
+    bool failed = false;
+    vector<char> buf;
+    size_t buf_at = 0;
+
+    void flush();
+    void put_char(const char c) { buf[buf_at++] = c; }
+    void put_uint(uint64_t v);
+    void write_header();
+};
+
+}
@@ -25,107 +25,310 @@ THE SOFTWARE.
 #include "solver.h"
 #include "occsimplifier.h"
 #include "clauseallocator.h"
+#ifdef STATS_NEEDED
 #include "sqlstats.h"
+#endif
+#include <algorithm>
 #include <limits>
-#include <map>
-#include <utility>
-#include <louvain_communities/louvain_communities.h>
-
-using std::map;
-using std::pair;
-using std::make_pair;
+#include <thread>
 
 using namespace CMSat;
 
+//Clauses above this size are not expanded into a clique, every literal is
+//connected to the next half of this many literals in the clause only
+static const uint32_t max_clique_size = 16;
+
+//Above this many (directed, pre-merge) edges we don't bother
+static const uint64_t max_edges = 200ULL*1000ULL*1000ULL;
+
 CommunityFinder::CommunityFinder(Solver* _solver) :
     solver(_solver)
 {
 }
 
-void CMSat::CommunityFinder::compute()
+uint64_t CommunityFinder::num_edges_of(const uint32_t size)
 {
-    //Clean it
-    for(auto& v: solver->varData) {
-        v.community_num = numeric_limits<uint32_t>::max();
+    if (size <= max_clique_size) return (uint64_t)size*(size-1)/2;
+    return (uint64_t)size*(max_clique_size/2);
+}
+
+// The weight of each clause is 1, spread over the edges it creates
+void CommunityFinder::add_clause_edges(const Lit* lits, const uint32_t size, vector<Edge>& out)
+{
+    const double weight = 1.0/(double)num_edges_of(size);
+    if (size <= max_clique_size) {
+        for(uint32_t i = 0; i < size; i++) {
+            for(uint32_t i2 = i+1; i2 < size; i2++) {
+                out.push_back(Edge(lits[i].var(), lits[i2].var(), weight));
+            }
+        }
+    } else {
+        for(uint32_t i = 0; i < size; i++) {
+            for(uint32_t j = 1; j <= max_clique_size/2; j++) {
+                out.push_back(Edge(lits[i].var(), lits[(i+j)%size].var(), weight));
+            }
+        }
     }
+}
 
-    //Check for too large
-    if (solver->nVars() > 300ULL*1000ULL) {
-        return;
+// Counting sort on the first node, then the (short) run of each node is
+// sorted on the second one and duplicates are summed up
+void CommunityFinder::sort_and_merge(vector<Edge>& edges, const uint32_t n)
+{
+    vector<uint32_t> start(n+1, 0);
+    for(const auto& e: edges) start[e.u+1]++;
+    for(uint32_t i = 0; i < n; i++) start[i+1] += start[i];
+    vector<Edge> sorted(edges.size());
+    vector<uint32_t> at(start.begin(), start.end()-1);
+    for(const auto& e: edges) sorted[at[e.u]++] = e;
+    vector<Edge>().swap(edges);
+
+    size_t j = 0;
+    for(uint32_t u = 0; u < n; u++) {
+        const auto b = sorted.begin() + start[u];
+        const auto e = sorted.begin() + start[u+1];
+        std::sort(b, e, [](const Edge& a, const Edge& c) {return a.v < c.v;});
+        const size_t run = j;
+        for(auto it = b; it != e; it++) {
+            if (j > run && sorted[j-1].v == it->v) sorted[j-1].w += it->w;
+            else sorted[j++] = *it;
+        }
     }
+    sorted.resize(j);
+    edges.swap(sorted);
+}
 
-    double my_time = cpuTime();
-    map<pair<uint32_t, uint32_t>, long double> edges;
-
-    //Binary clauses
-    for(uint32_t watched_at = 0; watched_at< solver->nVars()*2; watched_at++) {
-        Lit l = Lit::toLit(watched_at);
-        watch_subarray_const ws = solver->watches[l];
-        for(uint32_t watched_at_sub = 0; watched_at_sub < ws.size(); watched_at_sub++) {
-            const Watched& w = ws[watched_at_sub];
-            if (w.isBin() &&
-                w.lit2() < l &&
-                !w.red()
-            ) {
-                //VIG graph
-                uint32_t size = 2;
-                long double weight = 1.0L/((long double)size*((long double)size-1.0L)/2.0L);
-
-                uint32_t v1 = l.var();
-                uint32_t v2 = w.lit2().var();
-                //must start with smallest
-                if (v2  < v1) {
-                    std::swap(v1, v2);
-                }
-                auto edge = make_pair(v1, v2);
-                auto it = edges.find(edge);
-                if (it == edges.end()) {
-                    edges[edge] = weight;
-                } else {
-                    it->second+=weight;
-                }
+void CommunityFinder::build_edges(vector<Edge>& edges)
+{
+    //Binary clauses are always cheap, do them first
+    for(uint32_t at = 0; at < solver->nVars()*2; at++) {
+        const Lit l = Lit::toLit(at);
+        for(const Watched& w: solver->watches[l]) {
+            if (w.isBin() && w.lit2() < l && !w.red()) {
+                edges.push_back(Edge(l.var(), w.lit2().var(), 1.0));
             }
         }
     }
 
-    //Non-binary clauses
-    for(const auto& offs: solver->longIrredCls) {
-        const Clause* cl = solver->cl_alloc.ptr(offs);
-        //VIG graph
-        uint32_t size = cl->size();
-        long double weight = 1.0L/((long double)size*((long double)size-1.0L)/2.0L);
-        for(uint32_t i = 0; i < cl->size(); i ++) {
-            for(uint32_t i2 = i+1; i2 < cl->size(); i2 ++) {
-                uint32_t v1 = (*cl)[i].var();
-                uint32_t v2 = (*cl)[i2].var();
-
-                //must start with smallest
-                if (v2  < v1) {
-                    std::swap(v1, v2);
-                }
-                auto edge = make_pair(v1, v2);
-                auto it = edges.find(edge);
-                if (it == edges.end()) {
-                    edges[edge] = weight;
-                } else {
-                    it->second+=weight;
-                }
+    const auto& cls = solver->longIrredCls;
+    const uint32_t num_threads = std::max<uint32_t>(1, solver->conf.louvain_threads);
+    if (num_threads == 1) {
+        for(const auto& offs: cls) {
+            const Clause* cl = solver->cl_alloc.ptr(offs);
+            add_clause_edges(cl->begin(), cl->size(), edges);
+        }
+        sort_and_merge(edges, solver->nVars());
+        return;
+    }
+
+    //Every thread expands and merges a slice of the clauses, then the slices
+    //are merged once more
+    vector<vector<Edge>> parts(num_threads);
+    vector<std::thread> threads;
+    for(uint32_t t = 0; t < num_threads; t++) {
+        threads.push_back(std::thread([&, t]() {
+            const size_t at = (cls.size()*t)/num_threads;
+            const size_t end = (cls.size()*(t+1))/num_threads;
+            for(size_t i = at; i < end; i++) {
+                const Clause* cl = solver->cl_alloc.ptr(cls[i]);
+                add_clause_edges(cl->begin(), cl->size(), parts[t]);
             }
+            sort_and_merge(parts[t], solver->nVars());
+        }));
+    }
+    for(auto& t: threads) t.join();
+    for(auto& p: parts) {
+        edges.insert(edges.end(), p.begin(), p.end());
+        vector<Edge>().swap(p);
+    }
+    sort_and_merge(edges, solver->nVars());
+}
+
+// One level of Louvain: moves nodes to the neighbouring community with the
+// best modularity gain until nothing moves. As in Leiden's fast local moving,
+// a node is only looked at again once a neighbour of it moved away from its
+// community. Returns whether anything moved. The graph is symmetric CSR, self
+// loops are kept separately.
+bool CommunityFinder::local_moving(const Graph& g, vector<uint32_t>& comm) const
+{
+    const uint32_t n = g.offs.size()-1;
+    vector<double> k(n);
+    double m2 = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        k[i] = 2*g.self[i];
+        for(uint32_t at = g.offs[i]; at < g.offs[i+1]; at++) k[i] += g.w[at];
+        m2 += k[i];
+    }
+    comm.resize(n);
+    for(uint32_t i = 0; i < n; i++) comm[i] = i;
+    if (m2 == 0) return false;
+
+    vector<double> tot(k);
+    vector<double> neigh_w(n, -1);
+    vector<uint32_t> neigh;
+
+    //Circular, every node is in it at most once
+    vector<uint32_t> queue(n);
+    vector<char> queued(n, 1);
+    for(uint32_t i = 0; i < n; i++) queue[i] = i;
+    uint32_t q_head = 0;
+    uint32_t q_size = n;
+    uint64_t budget = 32ULL*n;
+
+    bool moved_any = false;
+    while(q_size > 0 && budget > 0) {
+        budget--;
+        const uint32_t i = queue[q_head];
+        q_head = (q_head+1 == n) ? 0 : q_head+1;
+        q_size--;
+        queued[i] = 0;
+
+        const uint32_t c_old = comm[i];
+        neigh.clear();
+        neigh_w[c_old] = 0;
+        neigh.push_back(c_old);
+        for(uint32_t at = g.offs[i]; at < g.offs[i+1]; at++) {
+            const uint32_t c = comm[g.adj[at]];
+            if (neigh_w[c] < 0) {
+                neigh_w[c] = 0;
+                neigh.push_back(c);
+            }
+            neigh_w[c] += g.w[at];
         }
+
+        tot[c_old] -= k[i];
+        uint32_t best = c_old;
+        double best_gain = neigh_w[c_old] - tot[c_old]*k[i]/m2;
+        for(const uint32_t c: neigh) {
+            const double gain = neigh_w[c] - tot[c]*k[i]/m2;
+            if (gain > best_gain) {
+                best_gain = gain;
+                best = c;
+            }
+            neigh_w[c] = -1;
+        }
+        tot[best] += k[i];
+        if (best == c_old) continue;
+
+        comm[i] = best;
+        moved_any = true;
+        for(uint32_t at = g.offs[i]; at < g.offs[i+1]; at++) {
+            const uint32_t j = g.adj[at];
+            if (queued[j] || comm[j] == best) continue;
+            queued[j] = 1;
+            queue[(uint64_t)(q_head + q_size) % n] = j;
+            q_size++;
+        }
+    }
+    return moved_any;
+}
+
+// Renumbers comm to 0..N-1 and returns the graph of the communities
+CommunityFinder::Graph CommunityFinder::aggregate(const Graph& g, vector<uint32_t>& comm) const
+{
+    const uint32_t n = g.offs.size()-1;
+    vector<uint32_t> renum(n, numeric_limits<uint32_t>::max());
+    uint32_t num = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        if (renum[comm[i]] == numeric_limits<uint32_t>::max()) renum[comm[i]] = num++;
+        comm[i] = renum[comm[i]];
+    }
+
+    Graph g2;
+    g2.self.assign(num, 0);
+    vector<Edge> edges;
+    for(uint32_t i = 0; i < n; i++) {
+        g2.self[comm[i]] += g.self[i];
+        for(uint32_t at = g.offs[i]; at < g.offs[i+1]; at++) {
+            const uint32_t j = g.adj[at];
+            if (j < i) continue;
+            if (comm[i] == comm[j]) g2.self[comm[i]] += g.w[at];
+            else edges.push_back(Edge(comm[i], comm[j], g.w[at]));
+        }
+    }
+    sort_and_merge(edges, num);
+    g2.build(num, edges);
+    return g2;
+}
+
+void CommunityFinder::Graph::build(const uint32_t n, const vector<Edge>& edges)
+{
+    offs.assign(n+1, 0);
+    for(const auto& e: edges) {
+        offs[e.u+1]++;
+        offs[e.v+1]++;
     }
+    for(uint32_t i = 0; i < n; i++) offs[i+1] += offs[i];
+    adj.resize(offs[n]);
+    w.resize(offs[n]);
+    vector<uint32_t> at(offs.begin(), offs.end()-1);
+    for(const auto& e: edges) {
+        adj[at[e.u]] = e.v; w[at[e.u]++] = e.w;
+        adj[at[e.v]] = e.u; w[at[e.v]++] = e.w;
+    }
+    if (self.size() != n) self.assign(n, 0);
+}
 
-    LouvainC::Communities graph;
-    for(const auto& it: edges) {
-        graph.add_edge(it.first.first, it.first.second, it.second);
+vector<uint32_t> CommunityFinder::find_communities()
+{
+    num_comms = 0;
+    levels = 0;
+    num_edges = 0;
+
+    //Check for too large
+    uint64_t expected_edges = 0;
+    for(const auto& offs: solver->longIrredCls) {
+        expected_edges += num_edges_of(solver->cl_alloc.ptr(offs)->size());
+    }
+    expected_edges += solver->binTri.irredBins;
+    if (expected_edges > max_edges) {
+        verb_print(1, "[louvain] too many edges: " << expected_edges << ", skipping");
+        return vector<uint32_t>();
     }
-    graph.calculate(true);
-    auto mapping = graph.get_mapping();
 
-    for(const auto& x: mapping) {
-        assert(x.first < solver->nVars());
-        assert(x.second < solver->nVars());
-        solver->varData[x.first].community_num = x.second;
+    vector<Edge> edges;
+    edges.reserve(expected_edges);
+    build_edges(edges);
+    num_edges = edges.size();
+
+    //Multi-level Louvain, "map" is var -> community at the current level
+    const uint32_t n = solver->nVars();
+    Graph g;
+    g.build(n, edges);
+    vector<Edge>().swap(edges);
+    vector<char> in_graph(n);
+    for(uint32_t v = 0; v < n; v++) in_graph[v] = g.offs[v+1] > g.offs[v];
+    vector<uint32_t> map(n);
+    for(uint32_t i = 0; i < n; i++) map[i] = i;
+    vector<uint32_t> comm;
+    while(local_moving(g, comm)) {
+        levels++;
+        g = aggregate(g, comm);
+        for(auto& m: map) m = comm[m];
+    }
+
+    for(uint32_t v = 0; v < n; v++) {
+        //Isolated vars don't get a community
+        if (!in_graph[v]) {
+            map[v] = numeric_limits<uint32_t>::max();
+            continue;
+        }
+        assert(map[v] < n);
+        num_comms = std::max(num_comms, map[v]+1);
+    }
+    return map;
+}
+
+#ifdef STATS_NEEDED
+void CMSat::CommunityFinder::compute()
+{
+    double my_time = cpuTime();
+    const vector<uint32_t> map = find_communities();
+    for(uint32_t v = 0; v < solver->nVars(); v++) {
+        solver->varData[v].community_num =
+            map.empty() ? numeric_limits<uint32_t>::max() : map[v];
     }
+    if (map.empty()) return;
 
     //Recompute connects_num_communities for all redundant clauses
     for(auto& cls: solver->longRedCls) {
@@ -139,7 +342,10 @@ void CMSat::CommunityFinder::compute()
 
     double time_passed = cpuTime() - my_time;
     if (solver->conf.verbosity) {
-        cout << "c [louvain] Louvain communities found. T: "
+        cout << "c [louvain] Louvain communities found: " << num_comms
+        << " edges: " << num_edges
+        << " levels: " << levels
+        << " T: "
         << std::fixed << std::setprecision(2)
         << solver->conf.print_times(time_passed) << endl;
     }
@@ -148,3 +354,4 @@ void CMSat::CommunityFinder::compute()
         solver->sqlStats->time_passed_min(solver, "louvain", time_passed);
     }
 }
+#endif
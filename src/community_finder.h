@@ -24,21 +24,59 @@ THE SOFTWARE.
 #ifndef COMMUNITY_FINDER_H__
 #define COMMUNITY_FINDER_H__
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
+#include "solvertypesmini.h"
 using std::vector;
 
 namespace CMSat {
 
 class Solver;
 
+// Louvain communities of the variable-interaction graph. The edges are built
+// in parallel, the local moving phase is sequential.
 class CommunityFinder {
 public:
     explicit CommunityFinder(Solver* _solver);
+    #ifdef STATS_NEEDED
+    // Into varData[].community_num
     void compute();
+    #endif
+
+    // Community of every var, numeric_limits<uint32_t>::max() for vars not
+    // in any irredundant clause. Empty if the graph is too large
+    vector<uint32_t> find_communities();
+    uint32_t num_comms = 0;
+    uint32_t levels = 0;
+    size_t num_edges = 0;
 
 private:
     Solver* solver;
 
+    struct Edge {
+        Edge() = default;
+        Edge(uint32_t a, uint32_t b, double _w) :
+            u(std::min(a, b)), v(std::max(a, b)), w(_w) {}
+        uint32_t u;
+        uint32_t v;
+        double w;
+    };
+
+    struct Graph {
+        vector<uint32_t> offs;
+        vector<uint32_t> adj;
+        vector<double> w;
+        vector<double> self; ///< Weight of the self loop of each node
+        void build(const uint32_t n, const vector<Edge>& edges);
+    };
+
+    static uint64_t num_edges_of(const uint32_t size);
+    static void add_clause_edges(const Lit* lits, const uint32_t size, vector<Edge>& out);
+    static void sort_and_merge(vector<Edge>& edges, const uint32_t n);
+    void build_edges(vector<Edge>& edges);
+    bool local_moving(const Graph& g, vector<uint32_t>& comm) const;
+    Graph aggregate(const Graph& g, vector<uint32_t>& comm) const;
 };
 
 }
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "frat.h"
 #include "shareddata.h"
 #include "solvertypesmini.h"
+#include "cnfwriter.h"
 
 #include <fstream>
 #include <cstdint>
@@ -161,227 +162,24 @@ DLL_PUBLIC SATSolver::~SATSolver()
     delete data;
 }
 
-void update_config(SolverConf& conf, unsigned thread_num)
+DLL_PUBLIC void CMSat::update_config(SolverConf& conf, unsigned thread_num)
 {
     //Don't accidentally reconfigure everything to a specific value!
     conf.origSeed += thread_num;
     conf.thread_num = thread_num;
+    conf.apply_preset(thread_num);
+}
 
-    switch(thread_num % 23) {
-        case 0: {
-            //default setup
-            break;
-        }
-
-        case 1: {
-            //Minisat-like
-            conf.branch_strategy_setup = "vsids";
-            conf.varElimRatioPerIter = 1;
-            conf.restartType = Restart::geom;
-            conf.polarity_mode = CMSat::PolarityMode::polarmode_neg;
-
-            conf.inc_max_temp_lev2_red_cls = 1.02;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
-            break;
-        }
-        case 2: {
-            conf.branch_strategy_setup = "vsids";
-//             conf.polar_best_inv_every_n = 100;
-            break;
-        }
-        case 3: {
-            //Similar to CMS 2.9 except we look at learnt DB size insteead
-            //of conflicts to see if we need to clean.
-            conf.branch_strategy_setup = "vsids";
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.5;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0;
-            conf.glue_put_lev0_if_below_or_eq = 0;
-            conf.inc_max_temp_lev2_red_cls = 1.03;
-            break;
-        }
-        case 4: {
-            //Similar to CMS 5.0
-            conf.branch_strategy_setup = "vsids";
-            conf.varElimRatioPerIter = 0.4;
-            conf.every_lev1_reduce = 0;
-            conf.every_lev2_reduce = 0;
-            conf.do_bva = false;
-            conf.max_temp_lev2_learnt_clauses = 30000;
-            conf.glue_put_lev0_if_below_or_eq = 4;
-
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
-            break;
-        }
-        case 5: {
-            conf.branch_strategy_setup = "vsids";
-            conf.never_stop_search = true;
-            break;
-        }
-        case 6: {
-            //Maple with backtrack
-            conf.branch_strategy_setup = "vsids";
-//             conf.polar_stable_every_n = 10000;
-            break;
-        }
-        case 7: {
-            conf.branch_strategy_setup = "vsids";
-            conf.do_bva = false;
-            conf.glue_put_lev0_if_below_or_eq = 2;
-            conf.varElimRatioPerIter = 1;
-            conf.inc_max_temp_lev2_red_cls = 1.04;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.1;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.3;
-            break;
-        }
-        case 8: {
-            //Different glue limit
-            conf.branch_strategy_setup = "vmtf";
-            conf.glue_put_lev0_if_below_or_eq = 2;
-            conf.glue_put_lev1_if_below_or_eq = 2;
-            break;
-        }
-        case 9: {
-            conf.branch_strategy_setup = "vsids";
-//             conf.polar_stable_every_n = 1;
-            break;
-        }
-        case 10: {
-            conf.branch_strategy_setup = "vsids";
-            conf.polarity_mode = CMSat::PolarityMode::polarmode_pos;
-//             conf.polar_stable_every_n = 100000;
-            break;
-        }
-        case 11: {
-            conf.branch_strategy_setup = "vsids";
-            conf.varElimRatioPerIter = 1;
-            conf.restartType = Restart::geom;
-
-            conf.inc_max_temp_lev2_red_cls = 1.01;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.3;
-            break;
-        }
-        case 12: {
-            conf.branch_strategy_setup = "vmtf";
-            conf.inc_max_temp_lev2_red_cls = 1.001;
-//             conf.polar_stable_every_n = 7;
-//             conf.polar_best_inv_every_n = 6;
-            break;
-        }
-
-        case 13: {
-            //Minisat-like
-            conf.varElimRatioPerIter = 1;
-            conf.restartType = Restart::geom;
-            conf.polarity_mode = CMSat::PolarityMode::polarmode_neg;
-
-            conf.inc_max_temp_lev2_red_cls = 1.02;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
-            break;
-        }
-        case 14: {
-            //Different glue limit
-            conf.branch_strategy_setup = "vsids";
-            conf.do_bva = false;
-            conf.doMinimRedMoreMore = 1;
-            conf.glue_put_lev0_if_below_or_eq = 4;
-            //conf.glue_put_lev2_if_below_or_eq = 8;
-            conf.max_num_lits_more_more_red_min = 3;
-            conf.max_glue_more_minim = 4;
-            break;
-        }
-        case 15: {
-            //Similar to CMS 2.9 except we look at learnt DB size insteead
-            //of conflicts to see if we need to clean.
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.5;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0;
-            conf.glue_put_lev0_if_below_or_eq = 0;
-            conf.inc_max_temp_lev2_red_cls = 1.03;
-//             conf.polar_stable_every_n = 2;
-            break;
-        }
-        case 16: {
-            //Similar to CMS 5.0
-            conf.varElimRatioPerIter = 0.4;
-            conf.every_lev1_reduce = 0;
-            conf.every_lev2_reduce = 0;
-            conf.max_temp_lev2_learnt_clauses = 30000;
-            conf.glue_put_lev0_if_below_or_eq = 4;
-
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
-            conf.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
-            break;
-        }
-        case 17: {
-            //conf.max_temporary_learnt_clauses = 10000;
-            conf.do_bva = true;
-            break;
-        }
-        case 18: {
-            conf.branch_strategy_setup = "vsids";
-            conf.every_lev1_reduce = 0;
-            conf.every_lev2_reduce = 0;
-            conf.glue_put_lev1_if_below_or_eq = 0;
-            conf.max_temp_lev2_learnt_clauses = 10000;
-            break;
-        }
-
-        case 19: {
-            conf.do_bva = false;
-            conf.doMinimRedMoreMore = 0;
-            conf.orig_global_timeout_multiplier = 5;
-            conf.num_conflicts_of_search_inc = 1.15;
-            conf.more_red_minim_limit_binary = 600;
-            conf.max_num_lits_more_more_red_min = 20;
-//             conf.polar_stable_every_n = 4;
-            //conf.max_temporary_learnt_clauses = 10000;
-            break;
-        }
-
-        case 20: {
-            //Luby
-            conf.branch_strategy_setup = "vmtf";
-            conf.restart_inc = 1.5;
-            conf.restart_first = 100;
-            conf.restartType = Restart::luby;
-//             conf.polar_stable_every_n = 2;
-            break;
-        }
-
-        case 21: {
-            conf.branch_strategy_setup = "vsids";
-            conf.glue_put_lev0_if_below_or_eq = 3;
-            conf.glue_put_lev1_if_below_or_eq = 5;
-            break;
-        }
-
-        case 22: {
-            conf.branch_strategy_setup = "vmtf";
-            conf.doMinimRedMoreMore = 0;
-            conf.orig_global_timeout_multiplier = 5;
-            conf.num_conflicts_of_search_inc = 1.15;
-            conf.more_red_minim_limit_binary = 600;
-            conf.max_num_lits_more_more_red_min = 20;
-            //conf.max_temporary_learnt_clauses = 10000;
-            break;
-        }
-
-        default: {
-            conf.varElimRatioPerIter = 0.1*(thread_num % 9);
-            if (thread_num % 4 == 0) {
-                conf.restartType = Restart::glue;
-            }
-            if (thread_num % 5 == 0) {
-                conf.restartType = Restart::geom;
-            }
-            conf.restart_first = 100 * (0.5*(thread_num % 5));
-            conf.doMinimRedMoreMore = ((thread_num % 5) == 1);
-            break;
-        }
+DLL_PUBLIC void SATSolver::set_shm_exchange(void* ring, unsigned proc_id)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: The multi-process portfolio runs a single thread per process";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
     }
+    //BreakID's clauses and aux vars differ between the processes
+    data->solvers[0]->conf.doBreakid = false;
+    data->solvers[0]->set_shm_ring((ShmRing*)ring, proc_id);
 }
 
 DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
@@ -414,12 +212,13 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         throw std::runtime_error(err);
     }
 
-    #ifdef USE_BREAKID
-    if (num > 1) {
-        cout << "ERROR: BreakID cannot work with multiple threads. Something is off in the memory allocation of the library that's likely 'static'. Perhaps in 'bliss'. Exiting." << endl;
-        exit(-1);
+    //Only the thread running BreakID would make its aux vars, and the
+    //variable numbering of the threads, which sharing relies on, would differ
+    if (data->solvers[0]->conf.doBreakid) {
+        const char err[] = "ERROR: BreakID cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
     }
-    #endif
 
     data->cls_lits.reserve(CACHE_SIZE);
     for(unsigned i = 1; i < num; i++) {
@@ -818,12 +617,14 @@ struct OneThreadCalc
         DataForThread& _data_for_thread,
         size_t _tid,
         Todo _todo,
-        bool _only_sampling_solution
+        bool _only_sampling_solution,
+        const string* _strategy
     ) :
         data_for_thread(_data_for_thread)
         , tid(_tid)
         , todo(_todo)
         , only_sampling_solution(_only_sampling_solution)
+        , strategy(_strategy)
     {
         assert(data_for_thread.cpu_times.size() > tid);
         assert(data_for_thread.solvers.size() > tid);
@@ -847,7 +648,7 @@ struct OneThreadCalc
         if (todo == Todo::todo_solve) {
             ret = data_for_thread.solvers[tid]->solve_with_assumptions(data_for_thread.assumptions, only_sampling_solution);
         } else if (todo == Todo::todo_simplify) {
-            ret = data_for_thread.solvers[tid]->simplify_with_assumptions(data_for_thread.assumptions);
+            ret = data_for_thread.solvers[tid]->simplify_with_assumptions(data_for_thread.assumptions, strategy);
         } else {
             assert(false);
         }
@@ -881,6 +682,7 @@ struct OneThreadCalc
     double start_time;
     Todo todo;
     bool only_sampling_solution;
+    const string* strategy;
 };
 
 lbool calc(
@@ -946,7 +748,7 @@ lbool calc(
     DataForThread data_for_thread(data, assumptions);
     vector<thread> thds;
     for(size_t i = 0 ; i < data->solvers.size() ; i++) {
-        thds.push_back(thread(OneThreadCalc( data_for_thread, i, todo, only_sampling_solution)));
+        thds.push_back(thread(OneThreadCalc( data_for_thread, i, todo, only_sampling_solution, strategy)));
     }
 
     for(std::thread& t: thds){
@@ -1017,6 +819,273 @@ DLL_PUBLIC const std::vector<Lit>& SATSolver::get_conflict() const
     return data->solvers[data->which_solved]->get_final_conflict();
 }
 
+// Deletion-based shrinking with clause-set refinement. The tail "chunk" of
+// the candidates is left out of the assumptions:
+// * UNSAT: the candidates are cut down to the ones in the new conflict
+// * SAT: if it's a single candidate, it's necessary. Otherwise, if the
+//   model falsifies only one of the chunk, then every conflict must contain
+//   that one (the model satisfies all the rest), so it's necessary, too.
+//   This is model rotation restricted to what the assumptions show.
+//   The chunk is then halved
+// * Out of budget: like SAT, but nothing is proven
+DLL_PUBLIC bool SATSolver::minimize_conflict(
+    vector<Lit>& out_conflict,
+    const uint64_t max_confl_per_probe,
+    const uint64_t max_confl)
+{
+    const double my_time = cpuTime();
+    vector<Lit> cands;
+    for(const Lit l: get_conflict()) cands.push_back(~l);
+    vector<Lit> necessary;
+    vector<Lit> assumps;
+    vector<char> in_confl;
+    const size_t orig_size = cands.size();
+    uint64_t confl_used = 0;
+    uint32_t probes = 0;
+    bool minimal = true;
+
+    size_t chunk = std::max<size_t>(cands.size()/2, 1);
+    while(!cands.empty()) {
+        if (confl_used >= max_confl) {
+            minimal = false;
+            break;
+        }
+        chunk = std::min(chunk, cands.size());
+        assumps = necessary;
+        assumps.insert(assumps.end(), cands.begin(), cands.end()-chunk);
+
+        set_max_confl(std::min(max_confl_per_probe, max_confl - confl_used));
+        const uint64_t confl_before = get_sum_conflicts();
+        const lbool ret = solve(&assumps);
+        confl_used += get_sum_conflicts() - confl_before;
+        probes++;
+
+        if (ret == l_False) {
+            const vector<Lit>& confl = get_conflict();
+            if (confl.empty()) {
+                //UNSAT without any assumptions
+                necessary.clear();
+                cands.clear();
+                break;
+            }
+            in_confl.assign(nVars()*2, 0);
+            for(const Lit l: confl) in_confl[(~l).toInt()] = 1;
+            size_t j = 0;
+            for(size_t i = 0; i < cands.size()-chunk; i++) {
+                if (in_confl[cands[i].toInt()]) cands[j++] = cands[i];
+            }
+            cands.resize(j);
+            continue;
+        }
+
+        if (chunk == 1) {
+            if (ret == l_Undef) minimal = false;
+            necessary.push_back(cands.back());
+            cands.pop_back();
+            continue;
+        }
+
+        if (ret == l_True) {
+            const vector<lbool>& model = get_model();
+            size_t num_false = 0;
+            size_t false_at = 0;
+            for(size_t i = cands.size()-chunk; i < cands.size(); i++) {
+                const Lit l = cands[i];
+                if (l.var() < model.size() && (model[l.var()] ^ l.sign()) == l_False) {
+                    num_false++;
+                    false_at = i;
+                }
+            }
+            if (num_false == 1) {
+                necessary.push_back(cands[false_at]);
+                cands.erase(cands.begin() + false_at);
+            }
+        }
+        chunk /= 2;
+    }
+    if (!cands.empty()) necessary.insert(necessary.end(), cands.begin(), cands.end());
+
+    out_conflict.clear();
+    for(const Lit l: necessary) out_conflict.push_back(~l);
+    if (get_verbosity()) {
+        cout << "c [core-min] " << orig_size << " -> " << out_conflict.size()
+        << " minimal: " << minimal
+        << " probes: " << probes
+        << " confl: " << confl_used
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - my_time)
+        << endl;
+    }
+    return minimal;
+}
+
+namespace {
+struct MaxSatSoft {
+    MaxSatSoft(Lit _lit, uint64_t _weight, uint32_t _card) :
+        lit(_lit), weight(_weight), card(_card) {}
+    Lit lit; //must be TRUE, we assume it
+    uint64_t weight;
+    uint32_t card; //index of the card it's the output of, or numeric_limits::max()
+};
+
+//lit "outs[i]" is TRUE iff at least i+2 of "ins" are TRUE
+struct MaxSatCard {
+    vector<Lit> ins;
+    vector<Lit> outs;
+};
+}
+
+DLL_PUBLIC lbool SATSolver::solve_maxsat(
+    const vector<std::pair<Lit, uint64_t>>& soft,
+    uint64_t& cost,
+    vector<lbool>& best_model,
+    const uint64_t max_confl)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: solve_maxsat() cannot be used in multi-threaded mode";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    const double my_time = cpuTime();
+    const uint32_t none = numeric_limits<uint32_t>::max();
+    cost = numeric_limits<uint64_t>::max();
+    best_model.clear();
+
+    vector<MaxSatSoft> softs;
+    vector<MaxSatCard> cards;
+    vector<uint32_t> lit_to_soft;
+    auto soft_at = [&](const Lit l) -> uint32_t& {
+        if (lit_to_soft.size() <= l.toInt()) lit_to_soft.resize(nVars()*2, none);
+        return lit_to_soft[l.toInt()];
+    };
+    for(const auto& p: soft) {
+        if (p.second == 0) continue;
+        uint32_t& at = soft_at(p.first);
+        if (at == none) {
+            at = softs.size();
+            softs.push_back(MaxSatSoft(p.first, 0, none));
+        }
+        softs[at].weight += p.second;
+    }
+
+    uint64_t lb = 0;
+    uint64_t stratum = 0;
+    for(const auto& s: softs) stratum = std::max(stratum, s.weight);
+    uint64_t confl_used = 0;
+    uint32_t iters = 0;
+    uint32_t cores = 0;
+    vector<Lit> assumps;
+    vector<Lit> core;
+    lbool ret = l_Undef;
+
+    while(true) {
+        if (confl_used >= max_confl) break;
+        assumps.clear();
+        for(const auto& s: softs) if (s.weight >= stratum && s.weight > 0) assumps.push_back(s.lit);
+
+        set_max_confl(max_confl - confl_used);
+        const uint64_t confl_before = get_sum_conflicts();
+        const lbool sat = solve(&assumps);
+        confl_used += get_sum_conflicts() - confl_before;
+        iters++;
+        if (sat == l_Undef) break;
+
+        if (sat == l_True) {
+            const vector<lbool>& model = get_model();
+            uint64_t this_cost = 0;
+            for(const auto& p: soft) {
+                if ((model[p.first.var()] ^ p.first.sign()) != l_True) this_cost += p.second;
+            }
+            if (this_cost < cost) {
+                cost = this_cost;
+                best_model = model;
+            }
+
+            //Lower the stratum, or done if all softs have been assumed
+            uint64_t next = 0;
+            for(const auto& s: softs) if (s.weight < stratum) next = std::max(next, s.weight);
+            if (cost == lb || next == 0) {
+                ret = l_True;
+                break;
+            }
+            stratum = next;
+            continue;
+        }
+
+        core = get_conflict();
+        if (core.empty()) {
+            ret = l_False;
+            break;
+        }
+        if (core.size() > 1) {
+            const uint64_t confl_before_min = get_sum_conflicts();
+            minimize_conflict(core, 1000, std::min<uint64_t>(max_confl - confl_used, 10000));
+            confl_used += get_sum_conflicts() - confl_before_min;
+        }
+        cores++;
+
+        uint64_t wmin = numeric_limits<uint64_t>::max();
+        for(const Lit l: core) wmin = std::min(wmin, softs[soft_at(~l)].weight);
+        lb += wmin;
+
+        for(const Lit l: core) {
+            const uint32_t at = soft_at(~l);
+            softs[at].weight -= wmin;
+
+            //Relaxing "at most j of the card" makes "at most j+1" the new soft
+            const uint32_t c = softs[at].card;
+            if (c == none) continue;
+            MaxSatCard& card = cards[c];
+            if (card.outs.back() != ~softs[at].lit
+                || card.outs.size()+1 >= card.ins.size()
+            ) {
+                continue;
+            }
+            new_var();
+            const Lit out = Lit(nVars()-1, false);
+            add_bnn_clause(card.ins, (signed)card.outs.size()+2, out);
+            card.outs.push_back(out);
+            soft_at(~out) = softs.size();
+            softs.push_back(MaxSatSoft(~out, wmin, c));
+        }
+
+        if (core.size() == 1) {
+            //Falsified no matter what, harden it
+            add_clause(core);
+        } else {
+            //The literals of the core that are FALSE, at most one of them is allowed for free
+            new_var();
+            const Lit out = Lit(nVars()-1, false);
+            cards.push_back(MaxSatCard());
+            cards.back().ins = core;
+            cards.back().outs.push_back(out);
+            add_bnn_clause(core, 2, out);
+            soft_at(~out) = softs.size();
+            softs.push_back(MaxSatSoft(~out, wmin, cards.size()-1));
+        }
+
+        if (get_verbosity()) {
+            cout << "c [maxsat] lb: " << lb
+            << " ub: " << (best_model.empty() ? string("none") : std::to_string(cost))
+            << " core: " << core.size()
+            << " stratum: " << stratum
+            << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - my_time)
+            << endl;
+        }
+    }
+
+    if (get_verbosity()) {
+        cout << "c [maxsat] finished: " << ret
+        << " cost: " << (best_model.empty() ? string("none") : std::to_string(cost))
+        << " lb: " << lb
+        << " iters: " << iters
+        << " cores: " << cores
+        << " confl: " << confl_used
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - my_time)
+        << endl;
+    }
+    return ret;
+}
+
 DLL_PUBLIC uint32_t SATSolver::nVars() const
 {
     return data->solvers[0]->nVarsOuter() + data->vars_to_add;
@@ -1654,34 +1723,35 @@ DLL_PUBLIC void SATSolver::set_varelim_check_resolvent_subs(bool varelim_check_r
     }
 }
 
-void into_rhs(vector<Lit>& lits, bool rhs) {
-    assert(!(lits.empty() && rhs == false));
-    if (!rhs) lits[0] ^= true;
-}
-
-DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses(const char* fname)
+DLL_PUBLIC bool SATSolver::dump_irred_clauses(
+    const std::string& fname, const bool simplified, const bool binary)
 {
-    start_getting_constraints(false);
-    uint32_t num_cls = 0;
-    int32_t max_vars = -1;
-    vector<Lit> lits; bool is_xor; bool rhs;
-    while (true) {
-        bool ret = get_next_constraint(lits, is_xor, rhs);
-        if (!ret) break;
-        num_cls++;
-        for(const Lit l: lits) {
-            if ((int32_t)l.var() > max_vars) max_vars = (int32_t)l.var();
-        }
+    const double my_time = cpuTime();
+    CNFWriter w(binary ? CNFWriter::Format::binary : CNFWriter::Format::dimacs);
+    if (!w.open(fname)) {
+        cout << "ERROR: Cannot open file '" << fname << "' for writing" << endl;
+        return false;
     }
 
-    std::ofstream f(fname);
-    f << "p cnf " << max_vars << " " << num_cls << endl;
-    while (true) {
-        bool ret = get_next_constraint(lits, is_xor, rhs);
-        if (!ret) break;
-        if (is_xor) {into_rhs(lits, rhs); f << "x " << lits << " 0\n";}
-        else f << lits << " 0\n";
+    start_getting_constraints(false, simplified);
+    vector<Lit> lits; bool is_xor; bool rhs;
+    while (get_next_constraint(lits, is_xor, rhs)) w.add(lits, is_xor, rhs);
+    end_getting_constraints();
+
+    const bool ok = w.close();
+    if (!ok) cout << "ERROR: Failed writing file '" << fname << "'" << endl;
+    if (get_verbosity()) {
+        cout << "c [dump] cls: " << w.num_cls << " vars: " << w.num_vars
+        << " binary: " << binary
+        << " T: " << std::setprecision(2) << std::fixed << (cpuTime() - my_time)
+        << endl;
     }
+    return ok;
+}
+
+DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses(const char* fname)
+{
+    dump_irred_clauses(fname);
 }
 
 DLL_PUBLIC void SATSolver::set_pred_short_size(int32_t sz)
@@ -1831,6 +1901,8 @@ DLL_PUBLIC bool SATSolver::backbone_simpl(int64_t max_confl, bool& finished)
 {
     Solver& s = *data->solvers[0];
     actually_add_clauses_to_threads(data);
+    //Reset the interrupt signal set at the end of the previous solve()
+    data->must_interrupt->store(false, std::memory_order_relaxed);
     return s.backbone_simpl(max_confl, finished);
 }
 
@@ -1851,6 +1923,14 @@ DLL_PUBLIC void SATSolver::set_oracle_removed_is_learnt(bool val) {
     s.conf.oracle_removed_is_learnt = val;
 }
 
+DLL_PUBLIC void SATSolver::set_oracle_vivif_threads(uint32_t num, double max_time) {
+    for (size_t i = 0; i < data->solvers.size(); ++i) {
+        Solver& s = *data->solvers[i];
+        s.conf.oracle_vivif_threads = num;
+        s.conf.oracle_vivif_max_time = max_time;
+    }
+}
+
 // Weight stuff
 DLL_PUBLIC bool SATSolver::get_weighted() const {
     const Solver& s = *data->solvers[0];
@@ -103,6 +103,7 @@ namespace CMSat {
         ////////////////////////////
 
         void set_num_threads(unsigned n); //Number of threads to use. Must be set before any vars/clauses are added
+        void set_shm_exchange(void* ring, unsigned proc_id); //Used by the multi-process portfolio of the executable. ring is a ShmRing*
         void set_allow_otf_gauss(); //allow on-the-fly gaussian elimination
         /**
          * CPU time (in seconds) that can be consumed before the next call to solve() must return
@@ -160,6 +161,7 @@ namespace CMSat {
         void set_orig_global_timeout_multiplier(const double mult);
         void set_oracle_get_learnts(bool val);
         void set_oracle_removed_is_learnt(bool val);
+        void set_oracle_vivif_threads(uint32_t num, double max_time = 0);
         double get_orig_global_timeout_multiplier();
         bool minimize_clause(std::vector<Lit>& cl);
 
@@ -247,6 +249,40 @@ namespace CMSat {
         bool implied_by(
             const std::vector<Lit>& lits, std::vector<Lit>& out_implied);
 
+        //Shrinks the conflict of the previous solve(), which must have returned l_False,
+        //by calling solve() under subsets of its assumptions. Learnt clauses are kept
+        //between these calls. Returns:
+        // 1) into "out_conflict" the shrunk conflict, in the same form as get_conflict()
+        // 2) Whether it's minimal, i.e. no literal can be removed. If "false": the budget
+        //    ran out and some literals were kept without being proven necessary
+        // NOTES:
+        // * Every call to solve() is limited to max_confl_per_probe conflicts, and all of
+        //   them together to max_confl
+        // * get_conflict() and get_model() are not restored, they belong to the last call
+        bool minimize_conflict(
+            std::vector<Lit>& out_conflict,
+            uint64_t max_confl_per_probe = 1000,
+            uint64_t max_confl = 100000);
+
+        //Weighted partial MaxSAT: finds a model of the clauses that minimises the sum
+        //of the weights of the soft literals that are FALSE in it. Core-guided (OLL)
+        //with stratification, on top of incremental solve(), so learnt clauses and
+        //heuristics are kept between the iterations. Returns:
+        // l_True:  "best_model" is optimal and "cost" is its cost
+        // l_False: the clauses are UNSAT
+        // l_Undef: max_confl ran out. If best_model is not empty, it is the best
+        //          model found and "cost" its cost
+        // NOTES:
+        // * The cardinality constraints over the cores are added as BNNs with fresh
+        //   output variables, and stay in the solver. Single-threaded only, throws
+        //   std::runtime_error after set_num_threads()
+        // * Soft literals with weight 0 are ignored
+        lbool solve_maxsat(
+            const std::vector<std::pair<Lit, uint64_t>>& soft,
+            uint64_t& cost,
+            std::vector<lbool>& best_model,
+            uint64_t max_confl = std::numeric_limits<uint64_t>::max());
+
         //////////////////////
         //Below must be done in-order. Multi-threading not allowed.
         void start_getting_constraints(
@@ -257,6 +293,13 @@ namespace CMSat {
         bool get_next_constraint(std::vector<Lit>& ret, bool& is_xor, bool& rhs);
         void end_getting_constraints();
 
+        //Writes the irredundant clauses and XORs in a single pass, as DIMACS or in
+        //the compact binary format of cnfwriter.h, which cryptominisat5 also reads.
+        //With "simplified" it is the simplified CNF, in the same numbering as
+        //start_getting_constraints() gives. Returns false if the file could not
+        //be written
+        bool dump_irred_clauses(const std::string& fname, bool simplified = false, bool binary = false);
+
         uint32_t simplified_nvars();
         std::vector<uint32_t> translate_sampl_set(const std::vector<uint32_t>& sampl_set);
 
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "varreplacer.h"
 #include "solver.h"
 #include "shareddata.h"
+#include "shmring.h"
 
 #include <iostream>
 #include <iomanip>
@@ -48,7 +49,7 @@ void DataSync::finish_up_mpi()
         assert(solver->conf.is_mpi);
         assert(solver->conf.thread_num == 0);
 
-        /*MPI_Status status;
+        MPI_Status status;
         int op_completed = false;
         int err;
 
@@ -57,10 +58,23 @@ void DataSync::finish_up_mpi()
         if (!op_completed) {
             err = MPI_Cancel(&sendReq);
             assert(err == MPI_SUCCESS);
-        }*/
+            err = MPI_Wait(&sendReq, &status);
+            assert(err == MPI_SUCCESS);
+        }
         delete[] mpiSendData;
         mpiSendData = nullptr;
     }
+
+    if (mpiLong) {
+        //A pending collective can be neither cancelled nor freed, and the
+        //other ranks may never join it as they are finishing too. Its buffers
+        //must outlive it, so in that case they are intentionally not freed
+        if (mpiLong->phase == MpiLongXchg::Phase::idle) {
+            delete mpiLong;
+            MPI_Comm_free(&mpiLongComm);
+        }
+        mpiLong = nullptr;
+    }
     #endif
 }
 
@@ -73,6 +87,13 @@ void DataSync::set_shared_data(SharedData* _sharedData)
     #endif
 }
 
+void DataSync::set_shm_ring(ShmRing* ring, const uint32_t proc_id)
+{
+    assert(!enabled() && "The multi-process portfolio runs one thread per process");
+    shm = ring;
+    shm_id = proc_id;
+}
+
 void DataSync::new_var(const bool bva)
 {
     if (!enabled())
@@ -104,15 +125,22 @@ void DataSync::updateVars(
 ) {
 }
 
+bool DataSync::sync_due()
+{
+    return (enabled() || shm != nullptr)
+        && lastSyncConf + solver->conf.sync_every_confl < solver->sumConflicts;
+}
+
 bool DataSync::syncData()
 {
-    if (!enabled()
-        || lastSyncConf + solver->conf.sync_every_confl >= solver->sumConflicts
-    ) {
-        return true;
-    }
+    if (!sync_due()) return true;
     numCalls++;
 
+    if (shm != nullptr) {
+        lastSyncConf = solver->sumConflicts;
+        return shm_sync();
+    }
+
     assert(sharedData != nullptr);
     assert(solver->decisionLevel() == 0);
 
@@ -139,12 +167,19 @@ bool DataSync::syncData()
         return false;
     }
 
+    sharedData->long_mutex.lock();
+    ok = shareLongData();
+    sharedData->long_mutex.unlock();
+    if (!ok) {
+        return false;
+    }
+
     #ifdef USE_MPI
     if (solver->conf.is_mpi
         && solver->conf.thread_num == 0)
     {
-        if (syncMPIFinish.size() < solver->nVarsOutside()*2) {
-            syncMPIFinish.resize(solver->nVarsOutside()*2, 0);
+        if (syncMPIFinish.size() < solver->nVarsOuter()*2) {
+            syncMPIFinish.resize(solver->nVarsOuter()*2, 0);
         }
 
         if (!mpi_get_interrupt()) {
@@ -157,6 +192,11 @@ bool DataSync::syncData()
             ) {
                 mpi_send_to_others();
             }
+            if (ok && mpiLong != nullptr) {
+                sharedData->long_mutex.lock();
+                mpi_exchange_long();
+                sharedData->long_mutex.unlock();
+            }
             sharedData->unit_mutex.unlock();
             sharedData->bin_mutex.unlock();
             if (!ok) {
@@ -241,11 +281,136 @@ bool DataSync::shareUnitData()
     return true;
 }
 
-void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl)
+void CMSat::DataSync::signal_new_long_clause(const vector<Lit>& cl, const uint32_t glue)
+{
+    if (!enabled() && shm == nullptr) return;
+    assert(thread_id != -1 || shm != nullptr);
+    if (cl.size() == 2) {
+        signal_new_bin_clause(cl[0], cl[1]);
+        return;
+    }
+
+    if (!solver->conf.do_share_long
+        || cl.size() < 3
+        || cl.size() > solver->conf.share_long_max_size
+        || glue > solver->conf.share_long_max_glue
+    ) {
+        return;
+    }
+    for(const Lit l: cl) if (solver->varData[l.var()].is_bva) return;
+
+    newLongClauses.push_back(cl.size());
+    newLongClauses.push_back(glue);
+    for(const Lit l: cl) newLongClauses.push_back(solver->map_inter_to_outer(l).toInt());
+}
+
+bool DataSync::shareLongData()
+{
+    assert(solver->okay());
+    uint32_t oldRecvLongData = stats.recvLongData;
+    uint32_t oldSentLongData = stats.sentLongData;
+
+    bool ok = syncLongFromOthers();
+    syncLongToOthers();
+    size_t mem = sharedData->calc_memory_use_longs();
+
+    if (solver->conf.verbosity >= 1) {
+        cout
+        << "c [sync " << thread_id << "  ]"
+        << " got longs " << (stats.recvLongData - oldRecvLongData)
+        << " (total: " << stats.recvLongData << ")"
+        << " sent longs " << (stats.sentLongData - oldSentLongData)
+        << " (total: " << stats.sentLongData << ")"
+        << " mem use: " << mem/(1024*1024) << " M"
+        << endl;
+    }
+
+    return ok;
+}
+
+bool DataSync::syncLongFromOthers()
 {
-    if (!enabled()) return;
-    assert(thread_id != -1);
-    if (cl.size() == 2) signal_new_bin_clause(cl[0], cl[1]);
+    const vector<uint32_t>& longs = sharedData->longs;
+    const uint64_t base = sharedData->long_base;
+    uint64_t at = (syncLongFinish < base) ? 0 : syncLongFinish - base;
+    while(at < longs.size()) {
+        const uint32_t sz = longs[at];
+        const uint32_t glue = longs[at+1];
+        const uint32_t origin = longs[at+2];
+        const uint32_t* lits = longs.data() + at + 3;
+        at += 3 + sz;
+        if (origin == (uint32_t)thread_id) continue;
+
+        stats.recvLongData++;
+        if (!import_clause(lits, sz, glue)) {
+            syncLongFinish = base + at;
+            return false;
+        }
+    }
+    syncLongFinish = base + longs.size();
+
+    solver->ok = solver->propagate<false>().isnullptr();
+    return solver->okay();
+}
+
+bool DataSync::import_clause(const uint32_t* lits, const uint32_t sz, const uint32_t glue)
+{
+    tmp_long.clear();
+    for(uint32_t i = 0; i < sz; i++) {
+        Lit lit = Lit::toLit(lits[i]);
+        if (lit.var() >= solver->nVarsOuter()) return true;
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].removed != Removed::none) return true;
+
+        const lbool val = solver->value(lit);
+        if (val == l_True) return true;
+        if (val == l_False) continue;
+        tmp_long.push_back(lit);
+    }
+
+    ClauseStats clstats;
+    clstats.which_red_array = 2;
+    clstats.glue = std::min<uint32_t>(glue, tmp_long.size());
+    clstats.last_touched_any = solver->sumConflicts;
+
+    //Don't add FRAT: it would add to the thread data, too
+    Clause* cl = solver->add_clause_int(tmp_long, true, &clstats, true, nullptr, false);
+    if (cl != nullptr) {
+        solver->longRedCls[2].push_back(solver->cl_alloc.get_offset(cl));
+    }
+    return solver->okay();
+}
+
+void DataSync::syncLongToOthers()
+{
+    vector<uint32_t>& longs = sharedData->longs;
+    for(size_t at = 0; at < newLongClauses.size();) {
+        const uint32_t sz = newLongClauses[at];
+        longs.push_back(sz);
+        longs.push_back(newLongClauses[at+1]);
+        longs.push_back(thread_id);
+        longs.insert(longs.end(),
+            newLongClauses.begin() + at + 2, newLongClauses.begin() + at + 2 + sz);
+        at += 2 + sz;
+        stats.sentLongData++;
+    }
+    newLongClauses.clear();
+    trim_shared_longs();
+
+    //Everything before is read, everything after is ours
+    syncLongFinish = sharedData->long_base + longs.size();
+}
+
+void DataSync::trim_shared_longs()
+{
+    vector<uint32_t>& longs = sharedData->longs;
+    if (longs.size() <= solver->conf.share_long_lits_limit_K*1000ULL) return;
+
+    size_t at = 0;
+    while(at < longs.size()/2) at += 3 + longs[at];
+    longs.erase(longs.begin(), longs.begin() + at);
+    sharedData->long_base += at;
 }
 
 bool DataSync::syncBinFromOthers()
@@ -404,7 +569,7 @@ bool DataSync::shareBinData()
 
 void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
 {
-    if (!enabled()) return;
+    if (!enabled() && shm == nullptr) return;
     if (solver->varData[lit1.var()].is_bva) return;
     if (solver->varData[lit2.var()].is_bva) return;
 
@@ -415,6 +580,106 @@ void DataSync::signal_new_bin_clause(Lit lit1, Lit lit2)
     newBinClauses.push_back(std::make_pair(lit1, lit2));
 }
 
+bool DataSync::shm_sync()
+{
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+    const uint32_t oldRecvShmData = stats.recvShmData;
+    const uint32_t oldSentShmData = stats.sentShmData;
+
+    if (!shm_recv()) return false;
+    shm_send();
+
+    if (solver->conf.verbosity >= 1) {
+        cout
+        << "c [sync proc " << shm_id << "]"
+        << " got cls " << (stats.recvShmData - oldRecvShmData)
+        << " (total: " << stats.recvShmData << ")"
+        << " sent cls " << (stats.sentShmData - oldSentShmData)
+        << " (total: " << stats.sentShmData << ")"
+        << endl;
+    }
+    return true;
+}
+
+bool DataSync::shm_recv()
+{
+    //Lock not taken: try again at the next sync
+    if (!shm->read(shm_read_pos, shm_buf)) return true;
+
+    for(size_t at = 0; at < shm_buf.size();) {
+        const uint32_t sz = shm_buf[at];
+        const uint32_t glue = shm_buf[at+1];
+        const uint32_t origin = shm_buf[at+2];
+        const uint32_t* lits = shm_buf.data() + at + 3;
+        at += 3 + sz;
+        if (origin == shm_id) continue;
+
+        stats.recvShmData++;
+        if (!import_clause(lits, sz, glue)) return false;
+    }
+
+    solver->ok = solver->propagate<false>().isnullptr();
+    return solver->okay();
+}
+
+void DataSync::shm_send()
+{
+    vector<uint32_t>& out = shm_buf;
+    out.clear();
+    uint32_t num = 0;
+    vector<uint32_t> new_units;
+
+    //Units that are new since the last send
+    if (shm_sent_value.size() < solver->nVarsOuter()) {
+        shm_sent_value.resize(solver->nVarsOuter(), l_Undef);
+    }
+    for (uint32_t var = 0; var < solver->nVarsOuter(); var++) {
+        if (shm_sent_value[var] != l_Undef) continue;
+        Lit lit = Lit(var, false);
+        lit = solver->varReplacer->get_lit_replaced_with_outer(lit);
+        lit = solver->map_outer_to_inter(lit);
+        if (solver->varData[lit.var()].is_bva) continue;
+        const lbool val = solver->value(lit);
+        if (val == l_Undef) continue;
+
+        shm_sent_value[var] = val;
+        new_units.push_back(var);
+        num++;
+        out.push_back(1);
+        out.push_back(1);
+        out.push_back(shm_id);
+        out.push_back(Lit(var, val == l_False).toInt());
+    }
+
+    for(const auto& bin: newBinClauses) {
+        out.push_back(2);
+        out.push_back(2);
+        out.push_back(shm_id);
+        out.push_back(bin.first.toInt());
+        out.push_back(bin.second.toInt());
+        num++;
+    }
+
+    for(size_t at = 0; at < newLongClauses.size();) {
+        const uint32_t sz = newLongClauses[at];
+        out.push_back(sz);
+        out.push_back(newLongClauses[at+1]);
+        out.push_back(shm_id);
+        out.insert(out.end(),
+            newLongClauses.begin() + at + 2, newLongClauses.begin() + at + 2 + sz);
+        at += 2 + sz;
+        num++;
+    }
+
+    //Lock not taken: the units are sent again next time, the clauses are lost
+    newBinClauses.clear();
+    newLongClauses.clear();
+    const bool pushed = shm->push(out);
+    if (!pushed) for(const uint32_t var: new_units) shm_sent_value[var] = l_Undef;
+    if (pushed) stats.sentShmData += num;
+}
+
 #ifdef USE_MPI
 void DataSync::set_up_for_mpi()
 {
@@ -427,6 +692,29 @@ void DataSync::set_up_for_mpi()
         assert(err == MPI_SUCCESS);
         release_assert(mpiRank != 0);
         assert(sharedData != nullptr);
+
+        //Worker ranks share long clauses among themselves, rank 0 only
+        //relays units and binaries
+        if (solver->conf.thread_num == 0
+            && solver->conf.do_share_long
+            && mpiSize > 2
+        ) {
+            MPI_Group world_group;
+            MPI_Group workers_group;
+            const int excl[1] = {0};
+            err = MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+            assert(err == MPI_SUCCESS);
+            err = MPI_Group_excl(world_group, 1, excl, &workers_group);
+            assert(err == MPI_SUCCESS);
+            err = MPI_Comm_create_group(MPI_COMM_WORLD, workers_group, 2, &mpiLongComm);
+            assert(err == MPI_SUCCESS);
+            MPI_Group_free(&workers_group);
+            MPI_Group_free(&world_group);
+
+            err = MPI_Comm_rank(mpiLongComm, &mpiLongRank);
+            assert(err == MPI_SUCCESS);
+            mpiLong = new MpiLongXchg;
+        }
     }
 }
 
@@ -510,9 +798,9 @@ bool DataSync::mpi_recv_from_others()
 
     //Unit clauses
     int at = 0;
-    assert(solver->nVarsOutside() == buf[at]);
+    assert(solver->nVarsOuter() == buf[at]);
     at++;
-    for (uint32_t var = 0; var < solver->nVarsOutside(); var++, at++) {
+    for (uint32_t var = 0; var < solver->nVarsOuter(); var++, at++) {
         const lbool otherVal = toLbool(buf[at]);
         if (!mpi_get_unit(otherVal, var, thisMpiRecvUnitData)) {
             #ifdef VERBOSE_DEBUG_MPI_SENDRCV
@@ -529,9 +817,9 @@ bool DataSync::mpi_recv_from_others()
     mpiRecvUnitData += thisMpiRecvUnitData;
 
     //Binary clauses
-    assert(buf[at] == solver->nVarsOutside()*2);
+    assert(buf[at] == solver->nVarsOuter()*2);
     at++;
-    for (uint32_t wsLit = 0; wsLit < solver->nVarsOutside()*2; wsLit++) {
+    for (uint32_t wsLit = 0; wsLit < solver->nVarsOuter()*2; wsLit++) {
         Lit lit = Lit::toLit(wsLit);
         uint32_t num = buf[at];
         at++;
@@ -558,25 +846,22 @@ void DataSync::mpi_send_to_others()
 {
     int err;
 
-    //We still are sending data, let's do that first
+    //We may still be sending the previous data. Don't wait for it, the new
+    //data will be sent at a later MPI sync
     if (mpiSendData != nullptr) {
-        #ifdef VERBOSE_DEBUG_MPI_SENDRCV
-        std::cout << "-->> MPI " << mpiRank << " thread " << thread_id <<
-        " Still sending data, waiting now." << std::endl;
-        #endif
-
-        /*MPI_Status status;
-        int op_completed;
-        err = MPI_Request_get_status(sendReq, &op_completed, &status);
+        MPI_Status status;
+        int op_completed = false;
+        err = MPI_Test(&sendReq, &op_completed, &status);
         assert(err == MPI_SUCCESS);
-        if (op_completed) {
-            err = MPI_Wait(&sendReq, &status);
-            assert(err == MPI_SUCCESS);*/
-            delete[] mpiSendData;
-            mpiSendData = nullptr;
-        /*} else {
+        if (!op_completed) {
+            #ifdef VERBOSE_DEBUG_MPI_SENDRCV
+            std::cout << "-->> MPI " << mpiRank << " thread " << thread_id <<
+            " Still sending data, skipping this send." << std::endl;
+            #endif
             return;
-        }*/
+        }
+        delete[] mpiSendData;
+        mpiSendData = nullptr;
     }
 
     #ifdef VERBOSE_DEBUG_MPI_SENDRCV
@@ -585,19 +870,19 @@ void DataSync::mpi_send_to_others()
     #endif
 
     //Set up units
-    assert(solver->nVarsOutside() == sharedData->value.size());
+    assert(solver->nVarsOuter() == sharedData->value.size());
     vector<uint32_t> data;
-    data.push_back(solver->nVarsOutside());
-    for (uint32_t var = 0; var < solver->nVarsOutside(); var++) {
+    data.push_back(solver->nVarsOuter());
+    for (uint32_t var = 0; var < solver->nVarsOuter(); var++) {
         data.push_back(toInt(sharedData->value[var]));
     }
 
     //Set up binaries
-    assert(sharedData->bins.size() == solver->nVarsOutside()*2);
+    assert(sharedData->bins.size() == solver->nVarsOuter()*2);
     uint32_t thisMpiSentBinData = 0;
-    data.push_back(solver->nVarsOutside()*2);
+    data.push_back(solver->nVarsOuter()*2);
 
-    for(uint32_t wsLit = 0; wsLit < solver->nVarsOutside()*2; wsLit++) {
+    for(uint32_t wsLit = 0; wsLit < solver->nVarsOuter()*2; wsLit++) {
         //Lit lit1 = ~Lit::toLit(wsLit);
         assert(syncMPIFinish.size() > wsLit);
         if (sharedData->bins[wsLit].data == nullptr) {
@@ -626,8 +911,7 @@ void DataSync::mpi_send_to_others()
     //Send the data
     mpiSendData = new uint32_t[data.size()];
     std::copy(data.begin(), data.end(), mpiSendData);
-    //err = MPI_Isend(mpiSendData, data.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD, &sendReq);
-    err = MPI_Send(mpiSendData, data.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD);
+    err = MPI_Isend(mpiSendData, data.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD, &sendReq);
     assert(err == MPI_SUCCESS);
 
     #ifdef VERBOSE_DEBUG_MPI_SENDRCV
@@ -636,13 +920,117 @@ void DataSync::mpi_send_to_others()
     #endif
 }
 
+void DataSync::mpi_exchange_long()
+{
+    MpiLongXchg& x = *mpiLong;
+    if (x.phase == MpiLongXchg::Phase::idle) {
+        mpi_start_long_exchange();
+        return;
+    }
+
+    int err;
+    int op_completed = false;
+    err = MPI_Test(&x.req, &op_completed, MPI_STATUS_IGNORE);
+    assert(err == MPI_SUCCESS);
+    if (!op_completed) return;
+
+    if (x.phase == MpiLongXchg::Phase::counts) {
+        int total = 0;
+        x.displs.resize(x.counts.size());
+        for(size_t i = 0; i < x.counts.size(); i++) {
+            x.displs[i] = total;
+            total += x.counts[i];
+        }
+        //All ranks see the same counts, so they all skip together
+        if (total == 0) {
+            x.phase = MpiLongXchg::Phase::idle;
+            return;
+        }
+        x.recv.resize(total);
+        err = MPI_Iallgatherv(
+            x.send.data(), x.my_count, MPI_UNSIGNED,
+            x.recv.data(), x.counts.data(), x.displs.data(), MPI_UNSIGNED,
+            mpiLongComm, &x.req);
+        assert(err == MPI_SUCCESS);
+        x.phase = MpiLongXchg::Phase::data;
+        return;
+    }
+
+    assert(x.phase == MpiLongXchg::Phase::data);
+    mpi_finish_long_exchange();
+    x.phase = MpiLongXchg::Phase::idle;
+}
+
+void DataSync::mpi_start_long_exchange()
+{
+    MpiLongXchg& x = *mpiLong;
+    const vector<uint32_t>& longs = sharedData->longs;
+    const uint64_t base = sharedData->long_base;
+
+    //Only send what was learnt by this rank, otherwise clauses would echo
+    x.send.clear();
+    uint64_t at = (mpiLongFinish < base) ? 0 : mpiLongFinish - base;
+    while(at < longs.size()) {
+        const uint32_t sz = longs[at];
+        if (longs[at+2] != SharedData::long_origin_remote) {
+            x.send.push_back(sz);
+            x.send.push_back(longs[at+1]);
+            x.send.insert(x.send.end(), longs.begin() + at + 3, longs.begin() + at + 3 + sz);
+            mpiSentLongData++;
+        }
+        at += 3 + sz;
+    }
+    mpiLongFinish = base + longs.size();
+
+    int num_workers;
+    int err = MPI_Comm_size(mpiLongComm, &num_workers);
+    assert(err == MPI_SUCCESS);
+    x.my_count = x.send.size();
+    x.counts.resize(num_workers);
+    err = MPI_Iallgather(
+        &x.my_count, 1, MPI_INT,
+        x.counts.data(), 1, MPI_INT,
+        mpiLongComm, &x.req);
+    assert(err == MPI_SUCCESS);
+    x.phase = MpiLongXchg::Phase::counts;
+}
+
+void DataSync::mpi_finish_long_exchange()
+{
+    MpiLongXchg& x = *mpiLong;
+    vector<uint32_t>& longs = sharedData->longs;
+    uint32_t thisMpiRecvLongData = 0;
+    for(size_t r = 0; r < x.counts.size(); r++) {
+        if ((int)r == mpiLongRank) continue;
+
+        size_t at = x.displs[r];
+        const size_t end = at + x.counts[r];
+        while(at < end) {
+            const uint32_t sz = x.recv[at];
+            longs.push_back(sz);
+            longs.push_back(x.recv[at+1]);
+            longs.push_back(SharedData::long_origin_remote);
+            longs.insert(longs.end(), x.recv.begin() + at + 2, x.recv.begin() + at + 2 + sz);
+            at += 2 + sz;
+            thisMpiRecvLongData++;
+        }
+    }
+    mpiRecvLongData += thisMpiRecvLongData;
+    trim_shared_longs();
+
+    #ifdef VERBOSE_DEBUG_MPI_SENDRCV
+    std::cout << "-->> MPI " << mpiRank << " thread " << thread_id <<
+    " Received " << thisMpiRecvLongData << " longs (total: " << mpiRecvLongData << ")" << std::endl;
+    #endif
+}
+
 bool DataSync::mpi_get_unit(
     const lbool otherVal,
     const uint32_t var,
     uint32_t& thisGotUnitData
 ) {
-    Lit l = Lit(var, false);
-    Lit lit1 = solver->map_to_with_bva(l);
+    //BVA is off with MPI, so the outside and outer numberings are the same
+    Lit lit1 = Lit(var, false);
     lit1 = solver->varReplacer->get_lit_replaced_with_outer(lit1);
     lit1 = solver->map_outer_to_inter(lit1);
     const lbool thisVal = solver->value(lit1);
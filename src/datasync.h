@@ -35,6 +35,7 @@ namespace CMSat {
 
 class Clause;
 class SharedData;
+class ShmRing;
 class Solver;
 class DataSync
 {
@@ -43,21 +44,27 @@ class DataSync
         void finish_up_mpi();
         bool enabled();
         void set_shared_data(SharedData* sharedData);
+        void set_shm_ring(ShmRing* ring, const uint32_t proc_id);
         void new_var(const bool bva);
         void new_vars(const size_t n);
         bool syncData();
+        bool sync_due();
         void save_on_var_memory();
         void updateVars(
            const vector<uint32_t>& outer_to_inter
             , const vector<uint32_t>& inter_to_outer
         );
-        void signal_new_long_clause(const vector<Lit>& clause);
+        void signal_new_long_clause(const vector<Lit>& clause, const uint32_t glue);
 
         struct Stats {
             uint32_t sentUnitData = 0;
             uint32_t recvUnitData = 0;
             uint32_t sentBinData = 0;
             uint32_t recvBinData = 0;
+            uint32_t sentLongData = 0;
+            uint32_t recvLongData = 0;
+            uint32_t sentShmData = 0;
+            uint32_t recvShmData = 0;
         };
         const Stats& get_stats() const;
 
@@ -71,25 +78,46 @@ class DataSync
         void clear_set_binary_values();
         bool add_bin_to_threads(const Lit lit1, const Lit lit2);
         void signal_new_bin_clause(Lit lit1, Lit lit2);
+        bool shareLongData();
+        bool syncLongFromOthers();
+        bool import_clause(const uint32_t* lits, const uint32_t sz, const uint32_t glue);
+        void syncLongToOthers();
+        void trim_shared_longs();
+        bool shm_sync();
+        bool shm_recv();
+        void shm_send();
 
         int thread_id = -1;
 
         //stuff to sync
         vector<std::pair<Lit, Lit> > newBinClauses;
+        vector<uint32_t> newLongClauses; ///< [size, glue, lits...] in OUTER numbering
+        vector<Lit> tmp_long;
 
         //stats
         uint64_t lastSyncConf = 0;
         vector<uint32_t> syncFinish;
+        uint64_t syncLongFinish = 0; ///< Absolute position in sharedData->longs
         Stats stats;
 
         //Other systems
         Solver* solver = nullptr;
         SharedData* sharedData = nullptr;
 
+        //Multi-process portfolio, only used when there is no sharedData
+        ShmRing* shm = nullptr;
+        uint32_t shm_id = 0;
+        uint64_t shm_read_pos = 0;
+        vector<uint32_t> shm_buf;
+        vector<lbool> shm_sent_value;
+
         #ifdef USE_MPI
         void set_up_for_mpi();
         bool mpi_recv_from_others();
         void mpi_send_to_others();
+        void mpi_exchange_long();
+        void mpi_start_long_exchange();
+        void mpi_finish_long_exchange();
         bool mpi_get_interrupt();
         bool mpi_get_unit(
             const lbool otherVal,
@@ -105,6 +133,26 @@ class DataSync
         uint32_t      mpiRecvUnitData = 0;
         uint32_t      mpiRecvBinData = 0;
         uint32_t      mpiSentBinData = 0;
+
+        //Long clauses are exchanged between the worker ranks only (i.e. not
+        //via rank 0), with non-blocking collectives on their own communicator.
+        //The exchange is advanced one step at every MPI sync, never waited on
+        struct MpiLongXchg {
+            enum class Phase {idle, counts, data};
+            Phase phase = Phase::idle;
+            MPI_Request req;
+            int my_count = 0;
+            vector<int> counts;
+            vector<int> displs;
+            vector<uint32_t> send; ///< [size, glue, lits...]
+            vector<uint32_t> recv;
+        };
+        MPI_Comm      mpiLongComm = MPI_COMM_NULL;
+        int           mpiLongRank = 0;
+        MpiLongXchg*  mpiLong = nullptr;
+        uint64_t      mpiLongFinish = 0; ///< Absolute position in sharedData->longs
+        uint32_t      mpiRecvLongData = 0;
+        uint32_t      mpiSentLongData = 0;
         #endif
 
         //misc
@@ -415,6 +415,12 @@ void CMSat::DataSyncServer::add_xor_clause(const vector<uint32_t>& vars, bool& r
     assert(false);
 }
 
+void CMSat::DataSyncServer::add_xor_clause(const vector<Lit>&, bool)
+{
+    std::cerr << "ERROR: XOR clauses are not supported in MPI mode" << std::endl;
+    std::exit(-1);
+}
+
 
 void CMSat::DataSyncServer::new_vars(uint32_t i)
 {
@@ -451,6 +457,7 @@ lbool DataSyncServer::actAsServer()
             //HACK below, we don't cleanly exit
             if (solution_val == l_True) {
                 cout << "s SATISFIABLE" << endl;
+                print_solution();
             } else if (solution_val == l_False) {
                 cout << "s UNSATISFIABLE" << endl;
             } else {
@@ -42,6 +42,16 @@ class DataSyncServer {
         void new_vars(uint32_t i);
         void new_var();
         void add_xor_clause(const vector<uint32_t>& vars, bool& rhs);
+        void add_xor_clause(const vector<Lit>& lits, bool rhs);
+        //Redundant clauses are implied, so adding them as irredundant is sound
+        void add_red_clause(const vector<Lit>& lits) { add_clause(lits); }
+
+        //Weights and sampling sets don't change satisfiability, ignore them
+        void set_weighted(const bool) {}
+        template<class T> void set_lit_weight(const Lit, const T&) {}
+        template<class T> void set_multiplier_weight(const T&) {}
+        void set_sampl_vars(const vector<uint32_t>&) {}
+        void set_opt_sampl_vars(const vector<uint32_t>&) {}
         uint32_t nVars() const {
             return num_vars;
         }
@@ -0,0 +1,181 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "elimed_cls_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace CMSat;
+using std::cerr;
+using std::endl;
+
+static int seek_file(FILE* f, const uint64_t at)
+{
+    #ifdef _MSC_VER
+    return _fseeki64(f, (__int64)at, SEEK_SET);
+    #else
+    return fseeko(f, (off_t)at, SEEK_SET);
+    #endif
+}
+
+ElimedClsStore::~ElimedClsStore()
+{
+    if (spill) fclose(spill);
+}
+
+void ElimedClsStore::add_clause(ElimedClauses& e, vector<Lit>& lits)
+{
+    assert(e.end == size());
+    const size_t at = mem.size();
+    mem.resize(at + (lits.size()+1)*max_enc_lit_bytes);
+    mem.resize(put_sorted_clause(lits, mem.data() + at) - mem.data());
+    num_lits += lits.size();
+    num_bytes += size() - e.end;
+    e.end = size();
+    maybe_spill();
+}
+
+void ElimedClsStore::get(const ElimedClauses& e, vector<Lit>& out) const
+{
+    out.clear();
+    const uint8_t* p;
+    if (e.start >= mem_base) {
+        p = mem.data() + (e.start - mem_base);
+    } else {
+        tmp.resize(e.end - e.start);
+        const uint64_t spilled_end = std::min(e.end, mem_base);
+        read_spilled(e.start, spilled_end, tmp.data());
+        if (e.end > mem_base) {
+            memcpy(tmp.data() + (spilled_end - e.start), mem.data(), e.end - mem_base);
+        }
+        p = tmp.data();
+    }
+    const uint8_t* const end = p + (e.end - e.start);
+
+    uint32_t prev = 0;
+    while(p < end) {
+        uint64_t v;
+        [[maybe_unused]] const bool ok = varint_get(p, end, v);
+        assert(ok);
+        if (v == 0) {
+            out.push_back(lit_Undef);
+            prev = 0;
+            continue;
+        }
+        prev += (uint32_t)(v - 1);
+        out.push_back(Lit::toLit(prev));
+    }
+}
+
+void ElimedClsStore::remove_marked(vector<ElimedClauses>& entries)
+{
+    uint64_t j_bytes = mem_base;
+    size_t j = 0;
+    for(size_t i = 0; i < entries.size(); i++) {
+        ElimedClauses e = entries[i];
+        if (e.toRemove) continue;
+
+        if (e.start < mem_base) {
+            //(partially) spilled, stays where it is
+            j_bytes = std::max(j_bytes, e.end);
+        } else {
+            const uint64_t sz = e.end - e.start;
+            if (e.start != j_bytes) {
+                memmove(mem.data() + (j_bytes - mem_base), mem.data() + (e.start - mem_base), sz);
+            }
+            e.start = j_bytes;
+            e.end = j_bytes + sz;
+            j_bytes += sz;
+        }
+        entries[j++] = e;
+    }
+    entries.resize(j);
+    mem.resize(j_bytes - mem_base);
+}
+
+void ElimedClsStore::maybe_spill()
+{
+    if (mem_limit == 0 || mem.size() <= mem_limit || spill_failed) return;
+
+    if (spill == nullptr) {
+        spill = tmpfile();
+        if (spill == nullptr) {
+            cerr << "c WARNING: could not create temporary file for eliminated clauses,"
+                << " keeping them in memory" << endl;
+            spill_failed = true;
+            return;
+        }
+    }
+
+    //Keep the newest half in memory
+    const uint64_t num = mem.size() - mem_limit/2;
+    if (seek_file(spill, mem_base) != 0
+        || fwrite(mem.data(), 1, num, spill) != num
+    ) {
+        cerr << "c WARNING: could not write eliminated clauses to temporary file,"
+            << " keeping them in memory" << endl;
+        spill_failed = true;
+        return;
+    }
+    memmove(mem.data(), mem.data() + num, mem.size() - num);
+    mem.resize(mem.size() - num);
+    mem.shrink_to_fit();
+    mem_base += num;
+    num_spills++;
+}
+
+void ElimedClsStore::read_spilled(const uint64_t from, const uint64_t to, uint8_t* out) const
+{
+    assert(from <= to && to <= mem_base);
+    if (from < win_start || to > win_start + win.size()) {
+        //Extension walks the stack downwards, so read the window below "to"
+        const uint64_t window = std::max<uint64_t>(4ULL*1024ULL*1024ULL, to - from);
+        win_start = (to > window) ? to - window : 0;
+        win.resize(to - win_start);
+        if (seek_file(spill, win_start) != 0
+            || fread(win.data(), 1, win.size(), spill) != win.size()
+        ) {
+            cerr << "ERROR: could not read back eliminated clauses from temporary file" << endl;
+            exit(-1);
+        }
+        num_spill_reads++;
+    }
+    memcpy(out, win.data() + (from - win_start), to - from);
+}
+
+size_t ElimedClsStore::mem_used() const
+{
+    return mem.capacity() + win.capacity() + tmp.capacity();
+}
+
+void ElimedClsStore::shrink_to_fit()
+{
+    mem.shrink_to_fit();
+    win.clear();
+    win.shrink_to_fit();
+    win_start = 0;
+    tmp.clear();
+    tmp.shrink_to_fit();
+}
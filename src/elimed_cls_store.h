@@ -0,0 +1,98 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+#include "solvertypes.h"
+#include "clause_enc.h"
+
+namespace CMSat {
+
+using std::vector;
+
+struct ElimedClauses {
+    ElimedClauses() = default;
+    explicit ElimedClauses(const Lit _on, const uint64_t _at, const bool _is_xor):
+        start(_at), end(_at), on(_on), is_xor(_is_xor) {}
+
+    uint64_t start; ///< Byte offset of the encoded clauses in ElimedClsStore
+    uint64_t end;
+    Lit on; ///< Literal (outer) it's eliminated on
+    bool toRemove = false;
+    bool is_xor = false;
+};
+
+// Stores the clauses of the elimed clause stack, in the sorted clause
+// encoding of clause_enc.h. Once the in-memory part grows over the memory
+// limit, its oldest half is written to a temporary file. These bytes belong
+// to the bottom of the stack, which is only walked at the end of the (reverse)
+// model extension, and are read back in large sequential windows.
+class ElimedClsStore
+{
+public:
+    ElimedClsStore() = default;
+    ~ElimedClsStore();
+    ElimedClsStore(const ElimedClsStore&) = delete;
+    ElimedClsStore& operator=(const ElimedClsStore&) = delete;
+
+    //Appends a clause of outer literals to e, which must be the last entry
+    void add_clause(ElimedClauses& e, vector<Lit>& lits);
+
+    //All clauses of e, each terminated by lit_Undef
+    void get(const ElimedClauses& e, vector<Lit>& out) const;
+
+    //Drops the entries marked toRemove. Only the in-memory bytes are moved,
+    //spilled bytes of removed entries stay in the file unused
+    void remove_marked(vector<ElimedClauses>& entries);
+
+    uint64_t size() const { return mem_base + mem.size(); }
+    size_t mem_used() const;
+    void shrink_to_fit();
+    void set_mem_limit(const uint64_t bytes) { mem_limit = bytes; }
+
+    uint64_t num_lits = 0; ///< Lits ever added
+    uint64_t num_bytes = 0; ///< Bytes ever added
+    uint64_t num_spills = 0;
+    mutable uint64_t num_spill_reads = 0;
+    uint64_t spilled_bytes() const { return mem_base; }
+
+private:
+    vector<uint8_t> mem; ///< Bytes [mem_base, size())
+    uint64_t mem_base = 0; ///< Bytes below this are in the spill file
+    uint64_t mem_limit = 0; ///< 0 means never spill
+    FILE* spill = nullptr;
+    bool spill_failed = false;
+
+    mutable vector<uint8_t> win; ///< Window of the spill file
+    mutable uint64_t win_start = 0;
+    mutable vector<uint8_t> tmp;
+
+    void maybe_spill();
+    void read_spilled(const uint64_t from, const uint64_t to, uint8_t* out) const;
+};
+
+}
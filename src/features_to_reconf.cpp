@@ -0,0 +1,90 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "features_to_reconf.h"
+#include <algorithm>
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::vector;
+using std::pair;
+using std::make_pair;
+
+namespace CMSat {
+
+// Preset 0 is the default search, the one with Gauss-Jordan elimination and
+// BNN propagation. XORs or BNNs found at startup make it the best choice, over
+// both other rules. With nothing found it is still ahead of them unless
+// their rule fires
+static double score_xor_bnn(const SatZillaFeatures& satzilla_feat)
+{
+	double score = 0.0;
+	if (satzilla_feat.num_xors_found_last > 0) score += 1.5;
+	if (satzilla_feat.num_bnns > 0) score += 1.5;
+	if (score == 0.0) score = 1.0;
+	return score;
+}
+
+// Preset 4 when over 60% of the clauses are binary
+static double score_mostly_binary(const SatZillaFeatures& satzilla_feat)
+{
+	return (satzilla_feat.binary > 0.6) ? 1.1 : 0.0;
+}
+
+// Preset 8 for instances with over 2M clauses, unless mostly binary
+static double score_large(const SatZillaFeatures& satzilla_feat)
+{
+	return (satzilla_feat.numClauses > 2000000) ? 1.05 : 0.0;
+}
+
+std::vector<int> get_reconf_ranking(const SatZillaFeatures& satzilla_feat, const int verb)
+{
+	vector<pair<double, int>> scores;
+
+	scores.push_back(make_pair(score_xor_bnn(satzilla_feat), 0));
+	scores.push_back(make_pair(score_mostly_binary(satzilla_feat), 4));
+	scores.push_back(make_pair(score_large(satzilla_feat), 8));
+
+	std::stable_sort(scores.begin(), scores.end(),
+		[](const pair<double, int>& a, const pair<double, int>& b) {
+			return a.first > b.first;
+	});
+
+	vector<int> ranking;
+	for(const auto& s: scores) {
+		if (verb >= 2)
+			cout << "c Score for reconf " << s.second << " is " << s.first << endl;
+		ranking.push_back(s.second);
+	}
+	return ranking;
+}
+
+int get_reconf_from_satzilla_features(const SatZillaFeatures& satzilla_feat, const int verb)
+{
+	const int best_val = get_reconf_ranking(satzilla_feat, verb)[0];
+	if (verb >= 2)
+		cout << "c Winning reconf is " << best_val << endl;
+	return best_val;
+}
+
+
+} //end namespace
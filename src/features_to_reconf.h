@@ -0,0 +1,41 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#ifndef FEATURES_TO_RECONF_H
+#define FEATURES_TO_RECONF_H
+
+#include <vector>
+#include "satzilla_features.h"
+
+namespace CMSat {
+
+// Hand-set heuristics scoring three presets of SolverConf::apply_preset():
+// 0 when XORs or BNNs were found, 4 for mostly-binary instances and 8 for
+// very large ones. Nothing here is trained.
+
+// Presets, best first
+std::vector<int> get_reconf_ranking(const SatZillaFeatures& satzilla_feat, const int verb);
+int get_reconf_from_satzilla_features(const SatZillaFeatures& satzilla_feat, const int verb);
+
+}
+
+#endif //FEATURES_TO_RECONF_H
@@ -374,6 +374,15 @@ void EGaussian::xor_in_bdd(const uint32_t a, const uint32_t b)
 }
 
 void EGaussian::eliminate() {
+    //FRAT needs to know which rows were XOR-ed, which the table-based
+    //kernel doesn't track
+    if (!solver->frat->enabled()
+        && (uint64_t)num_rows*num_cols >= solver->conf.gaussconf.m4ri_min_cells
+    ) {
+        eliminate_m4ri();
+        return;
+    }
+
     PackedMatrix::iterator end_row_it = mat.begin() + num_rows;
     PackedMatrix::iterator rowI = mat.begin();
     uint32_t row_i = 0;
@@ -425,6 +434,79 @@ void EGaussian::eliminate() {
     //print_matrix();
 }
 
+// Gauss-Jordan elimination with the Method of Four Russians. Columns are
+// processed in blocks of (at most) k pivots. The block's pivot rows are
+// found and kept reduced among themselves, then a table of all 2^k XOR
+// combinations of them is built, and every other row is cleared on the
+// block's pivot columns with a single row XOR. k is picked so the table
+// stays in L2, and rows are swept in order, so the row updates stream
+// through memory. Gives the same reduced row echelon form as the textbook
+// loop in eliminate()
+void EGaussian::eliminate_m4ri() {
+    const uint64_t row_bytes = sizeof(int64_t)*(num_cols/64 + 2);
+    uint32_t k = 1;
+    while (k < 8 && (row_bytes << (k+1)) <= 256*1024) k++;
+    PackedMatrix table;
+    table.resize(1U << k, num_cols);
+
+    vector<uint32_t> piv_cols;
+    uint32_t row_i = 0;
+    uint32_t col = 0;
+    while (row_i != num_rows && col != num_cols) {
+        //Find the pivots of the block. Searched rows are reduced by the
+        //block's pivots found so far, so the next pivot is reduced, too
+        piv_cols.clear();
+        const uint32_t block_start = row_i;
+        for (; col != num_cols && row_i != num_rows && piv_cols.size() < k; col++) {
+            uint32_t piv = num_rows;
+            for (uint32_t r = row_i; r < num_rows; r++) {
+                for (uint32_t p = 0; p < piv_cols.size(); p++) {
+                    if (mat[r][piv_cols[p]]) mat[r].xor_in(mat[block_start+p]);
+                }
+                if (mat[r][col]) {
+                    piv = r;
+                    break;
+                }
+            }
+            if (piv == num_rows) continue;
+
+            if (piv != row_i) {
+                mat[row_i].swapBoth(mat[piv]);
+                std::swap(reason_mat[row_i], reason_mat[piv]);
+            }
+            for (uint32_t p = 0; p < piv_cols.size(); p++) {
+                if (mat[block_start+p][col]) mat[block_start+p].xor_in(mat[row_i]);
+            }
+            var_has_resp_row[col_to_var[col]] = 1;
+            piv_cols.push_back(col);
+            row_i++;
+        }
+        if (piv_cols.empty()) break;
+
+        //table[mask] is the XOR of the pivot rows in mask. The entries with
+        //bit p set are the ones below it plus pivot row p
+        const uint32_t m = piv_cols.size();
+        table[0].setZero();
+        table[0].rhs() = 0;
+        for (uint32_t p = 0; p < m; p++) {
+            const uint32_t bit = 1U << p;
+            for (uint32_t i = 0; i < bit; i++) {
+                table[bit | i] = table[i];
+                table[bit | i].xor_in(mat[block_start+p]);
+            }
+        }
+
+        for (uint32_t r = 0; r < num_rows; r++) {
+            if (r >= block_start && r < block_start+m) continue;
+            uint32_t mask = 0;
+            for (uint32_t p = 0; p < m; p++) {
+                mask |= (uint32_t)mat[r][piv_cols[p]] << p;
+            }
+            if (mask) mat[r].xor_in(table[mask]);
+        }
+    }
+}
+
 vector<Lit>* EGaussian::get_reason(const uint32_t row, int32_t& out_ID) {
     frat_func_start();
     if (!xor_reasons[row].must_recalc) {
@@ -1470,6 +1552,19 @@ void CMSat::EGaussian::move_back_xor_clauses() {
     }
 }
 
+size_t CMSat::EGaussian::mem_used() const
+{
+    size_t mem = mat.mem_used();
+    for(const auto& r: reason_mat) mem += r.capacity();
+    for(const auto& x: xorclauses) mem += x.vars.capacity()*sizeof(uint32_t) + sizeof(Xor);
+    for(const auto& r: xor_reasons) mem += r.reason.capacity()*sizeof(Lit) + sizeof(XorReason);
+    mem += satisfied_xors.capacity();
+    mem += var_has_resp_row.capacity();
+    mem += row_to_var_non_resp.capacity()*sizeof(uint32_t);
+    mem += var_to_col.capacity()*sizeof(uint32_t);
+    mem += col_to_var.capacity()*sizeof(uint32_t);
+    return mem;
+}
 
 void CMSat::EGaussian::delete_reasons() {
     frat_func_start();
@@ -42,6 +42,10 @@ THE SOFTWARE.
 #include "gausswatched.h"
 #include "gqueuedata.h"
 
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
 //#define VERBOSE_DEBUG
 //#define DEBUG_GAUSS
 
@@ -99,6 +103,7 @@ class EGaussian {
     void finalize_frat();
     void delete_reasons();
     void move_back_xor_clauses();
+    size_t mem_used() const;
 
     vector<Xor> xorclauses;
 
@@ -124,7 +129,11 @@ class EGaussian {
     uint32_t get_max_level(const GaussQData& gqd, const uint32_t row_n);
 
     //Initialisation
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(m4ri, same_as_textbook_elimination);
+    #endif
     void eliminate();
+    void eliminate_m4ri();
     void fill_matrix();
     void select_columnorder();
     gret init_adjust_matrix(); // adjust matrix, include watch, check row is zero, etc.
@@ -41,6 +41,7 @@ struct GaussQData {
     uint32_t engaus_disable_checks = 0;
     bool disabled = false;  // Can be disabled. In this case, all xor constraints
                             // are reattached as plain XOR constraints
+    bool touched = false; // consulted for the literal being propagated
 
     void reset()
     {
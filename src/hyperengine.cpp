@@ -175,7 +175,7 @@ void HyperEngine::add_hyper_bin(const Lit p)
         cout << "Adding hyper-bin clause: " << p << " , "
         << ~deepestAncestor << " ID: " << ID << endl;
         #endif
-        needToAddBinClause.insert(BinaryClause(p, ~deepestAncestor, true, ID));
+        needToAddBinClause.push(BinaryClause(p, ~deepestAncestor, true, ID));
 
         hyperBinNotAdded = false;
     } else {
@@ -530,22 +530,18 @@ void HyperEngine::remove_bin_clause(Lit lit, const int32_t ID)
         cout << "Normal removing clause " << clauseToRemove << endl;
         #endif
         propStats.otfHyperTime += 2;
-        uselessBin.insert(clauseToRemove);
+        uselessBin.push_back(clauseToRemove);
     } else if (!varData[lit.var()].reason.getHyperbinNotAdded()) {
         #ifdef VERBOSE_DEBUG_FULLPROP
         cout << "Removing hyper-bin clause " << clauseToRemove << endl;
         #endif
-        propStats.otfHyperTime += needToAddBinClause.size()/4;
-        std::set<BinaryClause>::iterator it = needToAddBinClause.find(clauseToRemove);
+        propStats.otfHyperTime += 2;
 
         //In case this is called after a backtrack to decisionLevel 1
         //then in fact we might have already cleaned the
-        //'needToAddBinClause'. When called from probing, the IF below
-        //must ALWAYS be true
-        if (it != needToAddBinClause.end()) {
-            propStats.otfHyperTime += 2;
-            needToAddBinClause.erase(it);
-        }
+        //'needToAddBinClause'. When called from probing, it
+        //must ALWAYS be found
+        needToAddBinClause.remove(clauseToRemove);
         //This will subsume the clause later, so don't remove it
     }
 }
@@ -606,7 +602,7 @@ PropResult HyperEngine::prop_bin_with_ancestor_info(
             cout << "Removing this bin clause, ID: " << k->get_ID() << endl;
             #endif
             propStats.otfHyperTime += 2;
-            uselessBin.insert(BinaryClause(~p, lit, k->red(), k->get_ID()));
+            uselessBin.push_back(BinaryClause(~p, lit, k->red(), k->get_ID()));
         }
     }
 
@@ -651,6 +647,8 @@ size_t HyperEngine::mem_used() const
     size_t mem = 0;
     mem += PropEngine::mem_used();
     mem += currAncestors.capacity()*sizeof(Lit);
+    mem += needToAddBinClause.mem_used();
+    mem += uselessBin.capacity()*sizeof(BinaryClause);
 
     return mem;
 }
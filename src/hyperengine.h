@@ -27,16 +27,58 @@ THE SOFTWARE.
 #include "propby.h"
 #include "solvertypes.h"
 #include <vector>
-#include <set>
+#include <algorithm>
 #include "propengine.h"
 #include "mystack.h"
 
 
 using std::vector;
-using std::set;
 
 namespace CMSat {
 
+// Hyper-binary resolvents of the current propagate_bfs(). Every resolvent
+// gets a fresh, growing ID, so lookups are a binary search on the ID and
+// removal only marks the entry.
+class HyperBinBuffer {
+public:
+    void push(const BinaryClause& b) {
+        assert(cls.empty() || cls.back().getID() < b.getID());
+        cls.push_back(b);
+        removed.push_back(0);
+    }
+
+    //Returns whether it was found
+    bool remove(const BinaryClause& b) {
+        auto it = std::lower_bound(cls.begin(), cls.end(), b,
+            [](const BinaryClause& a, const BinaryClause& c) {return a.getID() < c.getID();});
+        if (it == cls.end() || it->getID() != b.getID() || removed[it-cls.begin()]) return false;
+        assert(*it == b);
+        removed[it-cls.begin()] = 1;
+        num_removed++;
+        return true;
+    }
+
+    template<class F> void for_each(F f) const {
+        for(size_t i = 0; i < cls.size(); i++) if (!removed[i]) f(cls[i]);
+    }
+
+    void clear() {
+        cls.clear();
+        removed.clear();
+        num_removed = 0;
+    }
+    size_t size() const { return cls.size() - num_removed; }
+    bool empty() const { return size() == 0; }
+    size_t mem_used() const {
+        return cls.capacity()*sizeof(BinaryClause) + removed.capacity();
+    }
+
+private:
+    vector<BinaryClause> cls;
+    vector<char> removed;
+    size_t num_removed = 0;
+};
+
 class HyperEngine : public PropEngine {
 public:
     HyperEngine(const SolverConf *_conf, Solver* solver, std::atomic<bool>* _must_interrupt_inter);
@@ -49,8 +91,8 @@ public:
     Lit propagate_bfs(
         const uint64_t earlyAborTOut = numeric_limits<uint64_t>::max()
     );
-    set<BinaryClause> needToAddBinClause;       ///<We store here hyper-binary clauses to be added at the end of propagateFull()
-    set<BinaryClause> uselessBin;
+    HyperBinBuffer needToAddBinClause; ///<We store here hyper-binary clauses to be added at the end of propagateFull()
+    vector<BinaryClause> uselessBin; ///<May contain duplicates, remove_useless_bins() drops them
 
     ///Add hyper-binary clause given this bin clause
     void  add_hyper_bin(Lit p);
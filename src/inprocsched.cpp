@@ -0,0 +1,183 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "inprocsched.h"
+#include "solver.h"
+#include "occsimplifier.h"
+#include "time_mem.h"
+
+#include <iomanip>
+
+using namespace CMSat;
+
+InprocSched::InprocSched(Solver* _solver) :
+    solver(_solver)
+    , start_time(cpuTime())
+{}
+
+// Bookkeeping tokens, the rest of the schedule relies on them. Also the
+// tokens whose gain is not fewer free vars or irredundant literals: they
+// find structure, a solution, or add clauses, and would always be backed off
+bool InprocSched::exempt(const string& token)
+{
+    return token.empty()
+        || token.substr(0, 5) == "must-"
+        || token == "renumber"
+        || token == "cl-consolidate"
+        || token == "clean-cls"
+        || token == "louvain-comms"
+        || token == "sls"
+        || token == "lucky"
+        || token == "card-find"
+        || token == "breakid"
+        || token == "bosphorus";
+}
+
+void InprocSched::new_round(const bool _adaptive)
+{
+    //A token returned early due to UNSAT
+    if (!open.empty()) {
+        solver->conf.global_timeout_multiplier = open.front().saved_mult;
+        open.clear();
+    }
+    adaptive = _adaptive;
+}
+
+double InprocSched::avg_rate() const
+{
+    double sum = 0;
+    uint32_t num = 0;
+    for(const auto& t: tokens) {
+        if (t.second.runs == 0 || exempt(t.first)) continue;
+        sum += t.second.rate;
+        num++;
+    }
+    return num == 0 ? 0 : sum/(double)num;
+}
+
+bool InprocSched::should_run(const string& token)
+{
+    //Nested calls are part of the token that called them
+    if (!adaptive || !open.empty() || exempt(token)) return true;
+
+    TokenStats& st = tokens[token];
+    if (st.skip_left > 0) {
+        st.skip_left--;
+        st.skipped++;
+        verb_print(1, "[inproc-sched] skipping '" << token << "', it did not pay off lately."
+            << " Skip left: " << st.skip_left);
+        return false;
+    }
+
+    const double all_time = cpuTime() - start_time;
+    if (st.runs > 0
+        && total_time > solver->conf.inproc_max_time_ratio*all_time
+        && st.rate < avg_rate()
+    ) {
+        st.skipped++;
+        verb_print(1, "[inproc-sched] skipping '" << token << "', inprocessing used "
+            << std::setprecision(2) << total_time << "s of " << all_time << "s and it pays off below average");
+        return false;
+    }
+    return true;
+}
+
+InprocSched::Snapshot InprocSched::take_snapshot(const string& token) const
+{
+    Snapshot s;
+    s.token = token;
+    s.time = cpuTime();
+    s.saved_mult = solver->conf.global_timeout_multiplier;
+    s.free_vars = solver->get_num_free_vars();
+    s.irred_size = solver->litStats.irredLits + 2*solver->binTri.irredBins;
+    return s;
+}
+
+void InprocSched::start(const string& token)
+{
+    open.push_back(take_snapshot(token));
+    if (adaptive && open.size() == 1 && !exempt(token)) {
+        solver->conf.global_timeout_multiplier *= tokens[token].budget_mult;
+    }
+}
+
+void InprocSched::finish(const string& token)
+{
+    assert(!open.empty());
+    const Snapshot before = open.back();
+    assert(before.token == token);
+    open.pop_back();
+    solver->conf.global_timeout_multiplier = before.saved_mult;
+
+    const Snapshot after = take_snapshot(token);
+    const double t = after.time - before.time;
+    double gain = 0;
+    gain += ((double)before.free_vars - (double)after.free_vars)/std::max<double>(before.free_vars, 1);
+    gain += ((double)before.irred_size - (double)after.irred_size)/std::max<double>(before.irred_size, 1);
+    gain = std::max(gain, 0.0);
+    if (open.empty()) total_time += t;
+
+    TokenStats& st = tokens[token];
+    if (exempt(token)) {
+        st.runs++;
+        st.time += t;
+        return;
+    }
+    update_stats(st, t, gain);
+    verb_print(2, "[inproc-sched] '" << token << "' T: " << std::setprecision(2) << t
+        << " gain: " << std::setprecision(4) << gain
+        << " budget mult: " << st.budget_mult << " skip next: " << st.skip_left);
+}
+
+void InprocSched::update_stats(TokenStats& st, const double t, const double gain)
+{
+    const double rate = gain/std::max(t, 0.001);
+    st.rate = (st.runs == 0) ? rate : (st.rate + rate)/2;
+    st.runs++;
+    st.time += t;
+    st.gain += gain;
+
+    if (gain > 0) {
+        st.backoff = 0;
+        st.budget_mult = std::min(st.budget_mult*1.2, 2.0);
+    } else if (t > 0.01) {
+        st.backoff = std::min<uint32_t>(std::max<uint32_t>(st.backoff*2, 1), 16);
+        st.skip_left = st.backoff;
+        st.budget_mult = std::max(st.budget_mult*0.5, 0.25);
+    }
+}
+
+void InprocSched::print_stats() const
+{
+    cout << "c [inproc-sched] token                 runs  skipped   time(s)    gain  budget" << endl;
+    for(const auto& t: tokens) {
+        const TokenStats& st = t.second;
+        cout << "c [inproc-sched] " << std::left << std::setw(20) << t.first << std::right
+            << " " << std::setw(7) << st.runs
+            << " " << std::setw(8) << st.skipped
+            << " " << std::setw(9) << std::fixed << std::setprecision(2) << st.time
+            << " " << std::setw(7) << std::setprecision(4) << st.gain
+            << " " << std::setw(7) << std::setprecision(2) << st.budget_mult
+            << std::defaultfloat << endl;
+    }
+}
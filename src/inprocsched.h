@@ -0,0 +1,102 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef INPROCSCHED_H
+#define INPROCSCHED_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
+namespace CMSat {
+
+using std::string;
+using std::vector;
+
+class Solver;
+
+// Keeps track of what every inprocessing token costs (time) and what it
+// gains (removed free vars, irredundant literals and binaries). Tokens that
+// keep costing time without any gain are skipped for exponentially growing
+// number of rounds and get a smaller time budget, tokens that pay off get a
+// larger one. Over the allowed inprocessing time ratio, only the tokens
+// paying off better than average are run. Tokens whose payoff does not show
+// up as fewer free vars or a smaller irredundant database are never
+// scheduled, they always run.
+class InprocSched
+{
+public:
+    explicit InprocSched(Solver* solver);
+
+    // Called once per simplification round, before any token
+    void new_round(const bool adaptive);
+    bool should_run(const string& token);
+    void start(const string& token);
+    void finish(const string& token);
+    void print_stats() const;
+
+private:
+    Solver* solver;
+
+    struct TokenStats {
+        uint64_t runs = 0;
+        uint64_t skipped = 0;
+        uint32_t skip_left = 0;
+        uint32_t backoff = 0;
+        double budget_mult = 1.0;
+        double time = 0;
+        double gain = 0;
+        double rate = 0; ///< Moving average of gain/second
+    };
+    std::map<string, TokenStats> tokens;
+
+    struct Snapshot {
+        string token;
+        double time;
+        double saved_mult;
+        uint64_t free_vars;
+        uint64_t irred_size;
+    };
+    vector<Snapshot> open;
+    Snapshot take_snapshot(const string& token) const;
+    void update_stats(TokenStats& st, const double t, const double gain);
+
+    bool adaptive = false;
+    const double start_time;
+    double total_time = 0;
+    double avg_rate() const;
+    static bool exempt(const string& token);
+
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(SolverTest, inproc_sched_backoff_and_budget);
+    FRIEND_TEST(SolverTest, inproc_sched_exempt_tokens);
+    #endif
+};
+
+} //end namespace
+
+#endif //INPROCSCHED_H
@@ -33,13 +33,25 @@ THE SOFTWARE.
 #include <sys/stat.h>
 #include <cstring>
 #include <thread>
+#include <algorithm>
 
 #include "main.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "cnfbinreader.h"
 #include "cryptominisat.h"
 #include "signalcode.h"
 #include "argparse.hpp"
+#include "shmring.h"
+
+#if !defined(_MSC_VER)
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
 
 using namespace CMSat;
 
@@ -67,6 +79,12 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
 {
     solver2->add_sql_tag("filename", filename);
     if (conf.verbosity) cout << "c Reading file '" << filename << "'" << endl;
+    if (CNFBinReader<SATSolver>::is_binary_cnf(filename)) {
+        CNFBinReader<SATSolver> reader(solver2);
+        if (!reader.parse(filename)) exit(-1);
+        return;
+    }
+
     #ifndef USE_ZLIB
     FILE * in = fopen(filename.c_str(), "rb");
     DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
@@ -236,6 +254,14 @@ void Main::add_supported_options() {
         .default_value(1)
         .action([&](const auto& a) {num_threads = std::atoi(a.c_str());})
         .help("Number of threads");
+    program.add_argument("--procs")
+        .action([&](const auto& a) {num_procs = std::atoi(a.c_str());})
+        .default_value(num_procs)
+        .help("Number of processes of a multi-process portfolio. A crashing process doesn't stop the others");
+    program.add_argument("--procsharemb")
+        .action([&](const auto& a) {proc_share_mb = std::atoll(a.c_str());})
+        .default_value(proc_share_mb)
+        .help("Size of the shared memory the portfolio processes exchange clauses through");
     program.add_argument("-m", "--mult")
         .action([&](const auto& a) {conf.orig_global_timeout_multiplier = std::atof(a.c_str());})
         .default_value(conf.orig_global_timeout_multiplier)
@@ -244,6 +270,22 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.global_next_multiplier = std::atof(a.c_str());})
         .default_value(conf.global_next_multiplier)
         .help("Global multiplier when the next inprocessing should take place");
+    program.add_argument("--adaptinproc")
+        .action([&](const auto& a) {conf.do_adaptive_inproc = std::atoi(a.c_str());})
+        .default_value(conf.do_adaptive_inproc)
+        .help("Skip and re-budget inprocessing steps based on how much they simplified the last times they ran");
+    program.add_argument("--inprocmaxratio")
+        .action([&](const auto& a) {conf.inproc_max_time_ratio = std::atof(a.c_str());})
+        .default_value(conf.inproc_max_time_ratio)
+        .help("Over this ratio of time spent in inprocessing, only run the steps paying off better than average");
+    program.add_argument("--maxmem")
+        .action([&](const auto& a) {conf.max_mem_mb = std::atoll(a.c_str());})
+        .default_value(conf.max_mem_mb)
+        .help("Memory budget in MB. When nearing it, the solver shrinks its learnt clause database, skips memory-hungry inprocessing and releases unused memory instead of growing further. 0 = no budget");
+    program.add_argument("--maxmemreact")
+        .action([&](const auto& a) {conf.mem_budget_react_ratio = std::atof(a.c_str());})
+        .default_value(conf.mem_budget_react_ratio)
+        .help("Start saving memory when over this ratio of the memory budget");
     program.add_argument("--memoutmult")
         .action([&](const auto& a) {conf.var_and_mem_out_mult = std::atof(a.c_str());})
         .default_value(conf.var_and_mem_out_mult)
@@ -395,6 +437,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.do_blocking_restart = std::atoi(a.c_str());})
         .default_value(conf.do_blocking_restart)
         .help("Do blocking restart for glues");
+    program.add_argument("--keepassump")
+        .action([&](const auto& a) {conf.keep_assump_levels_on_restart = std::atoi(a.c_str());})
+        .default_value(conf.keep_assump_levels_on_restart)
+        .help("On restart, keep the decision levels of the assumptions instead of re-deciding them, unless level-0 work is due. Levels are not kept between solve() calls");
 
     /* po::options_description reduceDBOptions("Redundant clause options"); */
     program.add_argument("--gluecut0")
@@ -423,6 +469,14 @@ void Main::add_supported_options() {
         .default_value(conf.every_pred_reduce)
         .help("Reduce final predictor (lev3) clauses every N, and produce data at every N in case of STATS_NEEDED");
     #endif
+    program.add_argument("--reconf")
+        .action([&](const auto& a) {conf.reconfigure_val = std::atoi(a.c_str());})
+        .default_value(conf.reconfigure_val)
+        .help("After the startup simplification, switch to this preset (1..22). 100 = pick preset from satzilla features, each thread taking the next best one. 0 = never");
+    program.add_argument("--szsamplem")
+        .action([&](const auto& a) {conf.satzilla_sample_litsM = std::atoll(a.c_str());})
+        .default_value(conf.satzilla_sample_litsM)
+        .help("Above this many million irredundant literals, compute satzilla features from a sample of the clauses. 0 = never sample");
     program.add_argument("--lev1usewithin")
         .action([&](const auto& a) {conf.must_touch_lev1_within = std::atoi(a.c_str());})
         .default_value(conf.must_touch_lev1_within)
@@ -527,6 +581,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.doTransRed = std::atoi(a.c_str());})
         .default_value(conf.doTransRed)
         .help("Remove useless binary clauses (transitive reduction)");
+    program.add_argument("--bitprobe")
+        .action([&](const auto& a) {conf.bit_parallel_probe = std::atoi(a.c_str());})
+        .default_value(conf.bit_parallel_probe)
+        .help("During binary-only probing, propagate 64 probes at once as bitmasks over the binary implication graph and only fully probe variables where that finds something");
     program.add_argument("--intree")
         .action([&](const auto& a) {conf.doIntreeProbe = std::atoi(a.c_str());})
         .default_value(conf.doIntreeProbe)
@@ -685,6 +743,14 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.varelim_time_limitM = std::atoll(a.c_str());})
         .default_value(conf.varelim_time_limitM)
         .help("Var elimination bogoprops M time limit");
+    program.add_argument("--incrextend")
+        .action([&](const auto& a) {conf.do_incremental_extend = std::atoi(a.c_str());})
+        .default_value(conf.do_incremental_extend)
+        .help("When extending the solution to eliminated vars, only re-walk the elimination stack entries whose inputs changed since the previous solution");
+    program.add_argument("--elimedmemlimitm")
+        .action([&](const auto& a) {conf.elimed_cls_mem_limitM = std::atoll(a.c_str());})
+        .default_value(conf.elimed_cls_mem_limitM)
+        .help("Keep at most this many MB of eliminated clauses in memory, spill the oldest ones to a temporary file. 0 = no limit");
     program.add_argument("--varelimover")
         .action([&](const auto& a) {conf.min_bva_gain = std::atoi(a.c_str());})
         .default_value(conf.min_bva_gain)
@@ -752,6 +818,14 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.doMinimRedMoreMore = std::atoi(a.c_str());})
         .default_value(conf.doMinimRedMoreMore)
         .help("Perform even stronger minimisation at conflict gen.");
+    program.add_argument("--shrink")
+        .action([&](const auto& a) {conf.do_shrink = std::atoi(a.c_str());})
+        .default_value(conf.do_shrink)
+        .help("Shrink learnt clauses by replacing the literals of a level with their block-UIP");
+    program.add_argument("--shrinkmaxglue")
+        .action([&](const auto& a) {conf.max_glue_shrink = std::atoi(a.c_str());})
+        .default_value(conf.max_glue_shrink)
+        .help("Only shrink learnt clauses with at most this glue");
     program.add_argument("--moremorealways")
         .action([&](const auto& a) {conf.doAlwaysFMinim = std::atoi(a.c_str());})
         .default_value(conf.doAlwaysFMinim)
@@ -888,6 +962,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.must_renumber = std::atoi(a.c_str());})
         .default_value(conf.must_renumber)
         .help("Treat all 'renumber' strategies as 'must-renumber'");
+    program.add_argument("--renumberthreads")
+        .action([&](const auto& a) {conf.renumber_threads = std::atoi(a.c_str());})
+        .default_value(conf.renumber_threads)
+        .help("Number of threads rewriting the clauses and watchlists when renumbering variables");
     program.add_argument("--fullwatchconseveryn")
         .action([&](const auto& a) {conf.full_watch_consolidate_every_n_confl = std::atoll(a.c_str());})
         .default_value(conf.full_watch_consolidate_every_n_confl)
@@ -914,12 +992,44 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.doFindCard = std::atoi(a.c_str());})
         .default_value(conf.doFindCard)
         .help("Find cardinality constraints");
+    program.add_argument("--backbonecadiback")
+        .action([&](const auto& a) {conf.backbone_use_cadiback = std::atoi(a.c_str());})
+        .default_value(conf.backbone_use_cadiback)
+        .help("Compute backbones by copying the CNF to CadiBack instead of using our own search under assumptions. Only if built with CadiBack");
+    program.add_argument("--oraclevivifthreads")
+        .action([&](const auto& a) {conf.oracle_vivif_threads = std::atoi(a.c_str());})
+        .default_value(conf.oracle_vivif_threads)
+        .help("Number of Oracle workers to vivify disjoint clause ranges with. Each worker holds a copy of the irredundant clauses");
+    program.add_argument("--oraclevivifsyncm")
+        .action([&](const auto& a) {conf.oracle_vivif_sync_memsM = std::atoll(a.c_str());})
+        .default_value(conf.oracle_vivif_sync_memsM)
+        .help("Oracle vivif workers exchange strengthened clauses every N million mems");
+    program.add_argument("--oraclevivifmaxtime")
+        .action([&](const auto& a) {conf.oracle_vivif_max_time = std::atof(a.c_str());})
+        .default_value(conf.oracle_vivif_max_time)
+        .help("Wall-clock budget (in seconds) of oracle-based vivification. 0 means unlimited");
+    program.add_argument("--louvainthreads")
+        .action([&](const auto& a) {conf.louvain_threads = std::atoi(a.c_str());})
+        .default_value(conf.louvain_threads)
+        .help("Number of threads building the variable-interaction graph for Louvain communities (STATS builds only). The local moving phase is sequential");
 
     /* hiddenOptions.add_options() */
     program.add_argument("--sync")
         .action([&](const auto& a) {conf.sync_every_confl = std::atoll(a.c_str());})
         .default_value(conf.sync_every_confl)
         .help("Sync threads every N conflicts");
+    program.add_argument("--sharelong")
+        .action([&](const auto& a) {conf.do_share_long = std::atoi(a.c_str());})
+        .default_value(conf.do_share_long)
+        .help("Share learnt long clauses between threads (and MPI ranks)");
+    program.add_argument("--sharelongsize")
+        .action([&](const auto& a) {conf.share_long_max_size = std::atoi(a.c_str());})
+        .default_value(conf.share_long_max_size)
+        .help("Only share learnt long clauses of at most this size");
+    program.add_argument("--sharelongglue")
+        .action([&](const auto& a) {conf.share_long_max_glue = std::atoi(a.c_str());})
+        .default_value(conf.share_long_max_glue)
+        .help("Only share learnt long clauses of at most this glue");
     program.add_argument("--clearinter")
         .action([&](const auto& a) {need_clean_exit = std::atoi(a.c_str());})
         .default_value(0)
@@ -991,6 +1101,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.gaussconf.max_num_matrices = std::atoi(a.c_str());})
         .default_value(conf.gaussconf.max_num_matrices)
         .help("Maximum number of matrices to treat.");
+    program.add_argument("--m4rimincells")
+        .action([&](const auto& a) {conf.gaussconf.m4ri_min_cells = std::atoll(a.c_str());})
+        .default_value(conf.gaussconf.m4ri_min_cells)
+        .help("Use Method of Four Russians elimination when initialising matrices with at least this many rows*columns");
     program.add_argument("--gaussusefulcutoff")
         .action([&](const auto& a) {conf.gaussconf.min_usefulness_cutoff = std::atof(a.c_str());})
         .default_value(conf.gaussconf.min_usefulness_cutoff)
@@ -1102,6 +1216,10 @@ void Main::manually_parse_some_options()
         conf.doBreakid = false;
     }
     #endif
+    if (conf.doBreakid && num_threads > 1) {
+        cerr << "ERROR: --threads cannot be used with --breakid" << endl;
+        exit(-1);
+    }
 
     if (conf.max_glue_cutoff_gluehistltlimited > 1000) {
         cout << "ERROR: 'Maximum supported glue size is currently 100000" << endl;
@@ -1233,6 +1351,8 @@ void Main::check_num_threads_sanity(const unsigned thread_num) const
 
 int Main::solve()
 {
+    if (num_procs > 1 && proc_ring == nullptr) return solve_multi_proc();
+
     wallclock_time_started = real_time_sec();
     solver = new SATSolver((void*)&conf);
     solverToInterrupt = solver;
@@ -1244,6 +1364,7 @@ int Main::solve()
     parse_sampling_vars();
     check_num_threads_sanity(num_threads);
     solver->set_num_threads(num_threads);
+    if (proc_ring) solver->set_shm_exchange(proc_ring, proc_id);
     if (sql != 0) solver->set_sqlite(sqlite_filename);
 
     //Print command line used to execute the solver: for options and inputs
@@ -1286,6 +1407,11 @@ int Main::solve()
     }
 
     lbool ret = multi_solutions();
+    if (proc_ring && (ret == l_Undef || !((ShmRing*)proc_ring)->claim_win(proc_id))) {
+        //Another process of the portfolio answers
+        cout << std::flush;
+        std::_Exit(0);
+    }
     if (ret == l_Undef && conf.verbosity) {
         cout
         << "c Not finished running -- signal caught or some maximum reached"
@@ -1316,6 +1442,93 @@ int Main::solve()
     return correctReturnValue(ret);
 }
 
+int Main::solve_multi_proc()
+{
+    #if defined(_MSC_VER)
+    cerr << "ERROR: --procs is not supported on this platform" << endl;
+    exit(-1);
+    #else
+    if (num_threads > 1 || fratf || idrupf || max_nr_of_solutions > 1) {
+        cerr << "ERROR: --procs cannot be used with multiple threads, proofs or multiple solutions" << endl;
+        exit(-1);
+    }
+    //Every process would add its own symmetry breaking clauses over its own
+    //aux vars, and the clauses learnt from them would be shared with the rest
+    if (conf.doBreakid) {
+        cerr << "ERROR: --procs cannot be used with --breakid" << endl;
+        exit(-1);
+    }
+
+    ShmRing* ring = ShmRing::create(proc_share_mb*1024ULL*1024ULL);
+    if (ring == nullptr) {
+        cerr << "ERROR: Could not map " << proc_share_mb << " MB of shared memory: " << strerror(errno) << endl;
+        exit(-1);
+    }
+    cout << std::flush;
+
+    vector<pid_t> pids;
+    for(unsigned i = 0; i < num_procs; i++) {
+        const pid_t pid = fork();
+        if (pid == -1) {
+            cerr << "ERROR: fork() failed: " << strerror(errno) << endl;
+            for(const pid_t p: pids) kill(p, SIGKILL);
+            exit(-1);
+        }
+        if (pid == 0) {
+            #ifdef __linux__
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            #endif
+            proc_ring = ring;
+            proc_id = i;
+            if (i > 0) {
+                update_config(conf, i);
+                conf.verbosity = 0;
+            }
+            return solve();
+        }
+        pids.push_back(pid);
+    }
+
+    //The processes get the terminal's SIGINT and print their own stats
+    signal(SIGINT, SIG_IGN);
+    if (conf.verbosity) {
+        cout << "c [procs] started " << num_procs << " processes" << endl;
+    }
+
+    int ret = -1;
+    size_t running = pids.size();
+    while(running > 0) {
+        int status;
+        const pid_t pid = wait(&status);
+        if (pid == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        running--;
+
+        const size_t at = std::find(pids.begin(), pids.end(), pid) - pids.begin();
+        if (ring->get_winner() == (int32_t)at) {
+            ret = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            break;
+        }
+        if (conf.verbosity && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+            cout << "c [procs] process " << at << " failed, "
+            << running << " processes remain" << endl;
+        }
+    }
+
+    for(const pid_t p: pids) kill(p, SIGKILL);
+    for(const pid_t p: pids) waitpid(p, nullptr, 0);
+    ShmRing::destroy(ring);
+
+    if (ret == -1) {
+        cout << "s INDETERMINATE" << endl;
+        return correctReturnValue(l_Undef);
+    }
+    return ret;
+    #endif
+}
+
 lbool Main::multi_solutions()
 {
     if (max_nr_of_solutions == 1
@@ -65,6 +65,7 @@ class Main: public MainCommon
         void parse_polarity_type();
         void parse_sampling_vars();
         void check_num_threads_sanity(const unsigned thread_num) const;
+        int solve_multi_proc();
         argparse::ArgumentParser program = argparse::ArgumentParser("cryptominisat5");
 
     protected:
@@ -98,6 +99,12 @@ class Main: public MainCommon
         string sqlite_filename;
         uint64_t maxconfl;
 
+        //Multi-process portfolio
+        unsigned num_procs = 1;
+        uint64_t proc_share_mb = 64;
+        void* proc_ring = nullptr; ///< ShmRing shared with the other processes
+        unsigned proc_id = 0;
+
         //Sampling vars
         bool only_sampl_solution = false;
         std::string assump_filename;
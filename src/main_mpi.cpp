@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 using std::cout;
 using std::endl;
+using namespace CMSat;
 
 
 int num_threads = 2;
@@ -198,7 +199,7 @@ int main(int argc, char** argv)
         const vector<lbool> model = solve(solution_val);
         #ifdef VERBOSE_DEBUG_MPI_SENDRCV
         cout << "c --> MPI Slave Rank " << mpiRank
-        << " Solved " <<  << " with value: " << solution_val << std::endl;
+        << " solved with value: " << solution_val << std::endl;
         #endif
 
         if (solution_val != l_Undef) {
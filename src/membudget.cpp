@@ -0,0 +1,158 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+#include "membudget.h"
+#include "solver.h"
+#include "occsimplifier.h"
+#include "reducedb.h"
+#include "gaussian.h"
+#include "varreplacer.h"
+#include "time_mem.h"
+
+#include <iomanip>
+
+using namespace CMSat;
+
+MemBudget::MemBudget(Solver* _solver) :
+    solver(_solver)
+{}
+
+uint64_t MemBudget::used() const
+{
+    uint64_t mem = 0;
+    mem += solver->mem_used_longclauses();
+    mem += solver->watches.mem_used();
+    mem += solver->mem_used();
+    mem += solver->mem_used_vardata();
+    mem += solver->mem_used_renumberer();
+    #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
+    mem += solver->red_stats_extra.capacity()*sizeof(ClauseStatsExtra);
+    #endif
+    mem += solver->varReplacer->mem_used();
+    mem += solver->reduceDB->mem_used();
+    if (solver->occsimplifier) mem += solver->occsimplifier->mem_used();
+    for(const auto& g: solver->gmatrices) if (g) mem += g->mem_used();
+    return mem;
+}
+
+MemBudget::Level MemBudget::level() const
+{
+    if (solver->conf.max_mem_mb == 0) return Level::ok;
+    const double limit = (double)solver->conf.max_mem_mb*1024.0*1024.0;
+    const double mem = used();
+    if (mem >= limit) return Level::over;
+    if (mem >= limit*solver->conf.mem_budget_react_ratio) return Level::tight;
+    return Level::ok;
+}
+
+MemBudget::Level MemBudget::update()
+{
+    num_checks++;
+    cur = level();
+    max_used = std::max(max_used, used());
+    if (cur == Level::over && !warned) {
+        warned = true;
+        verb_print(1, "[mem-budget] WARNING: over the memory budget of "
+            << solver->conf.max_mem_mb << " MB, degrading to save memory");
+    }
+    return cur;
+}
+
+void MemBudget::shrink_lev2()
+{
+    //Nothing was learnt since the last shrink, it would free nothing
+    const size_t before = solver->longRedCls[2].size();
+    if (num_lev2_shrinks > 0 && before <= lev2_after_shrink) return;
+
+    solver->reduceDB->handle_lev2(cur == Level::over ? 0.25 : 0.5);
+    solver->cl_alloc.consolidate(solver, true, true);
+    lev2_after_shrink = solver->longRedCls[2].size();
+    num_lev2_shrinks++;
+    verb_print(1, "[mem-budget] " << (cur == Level::over ? "over" : "near")
+        << " budget, shrunk tier-2 from " << before << " to " << solver->longRedCls[2].size()
+        << " clauses, now using " << used()/(1024ULL*1024ULL) << " MB");
+}
+
+void MemBudget::check_during_search()
+{
+    if (solver->conf.max_mem_mb == 0 || solver->sumConflicts < next_search_check) return;
+    next_search_check = solver->sumConflicts
+        + solver->conf.mem_budget_check_every_confl*search_check_mult;
+    if (update() == Level::ok) {
+        search_check_mult = 1;
+        return;
+    }
+
+    //If the irredundant clauses are what use the memory, shrinking tier-2
+    //doesn't help, so check less and less often
+    shrink_lev2();
+    if (update() != Level::ok) search_check_mult = std::min<uint64_t>(search_check_mult*2, 64);
+    else search_check_mult = 1;
+}
+
+void MemBudget::check_before_inprocess()
+{
+    if (solver->conf.max_mem_mb == 0) return;
+    if (update() == Level::ok) return;
+
+    shrink_lev2();
+    solver->save_on_var_memory(solver->nVars());
+    num_releases++;
+    update();
+}
+
+// These build large temporary structures (occurrence lists, copies of the
+// CNF, etc.) compared to what they free up
+static bool mem_hungry(const string& token)
+{
+    return token.substr(0, 3) == "occ"
+        || token.substr(0, 6) == "oracle"
+        || token == "backbone"
+        || token == "breakid"
+        || token == "bosphorus"
+        || token == "sls"
+        || token == "card-find"
+        || token == "louvain-comms";
+}
+
+bool MemBudget::allows(const string& token)
+{
+    if (cur == Level::ok || !mem_hungry(token)) return true;
+    num_skipped++;
+    verb_print(1, "[mem-budget] skipping '" << token << "', memory is "
+        << (cur == Level::over ? "over" : "near") << " the budget");
+    return false;
+}
+
+void MemBudget::print_stats() const
+{
+    if (solver->conf.max_mem_mb == 0) return;
+    cout << "c [mem-budget] budget: " << solver->conf.max_mem_mb << " MB"
+        << " max accounted: " << max_used/(1024ULL*1024ULL) << " MB"
+        << " checks: " << num_checks
+        << " T2 shrinks: " << num_lev2_shrinks
+        << " releases: " << num_releases
+        << " skipped tokens: " << num_skipped
+        << endl;
+}
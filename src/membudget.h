@@ -0,0 +1,89 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+#ifndef MEMBUDGET_H
+#define MEMBUDGET_H
+
+#include <string>
+#include <cstdint>
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
+
+namespace CMSat {
+
+using std::string;
+
+class Solver;
+
+// Keeps the memory accounted for by the solver's components (clause
+// allocator, watches, occurrence simplifier, Gauss matrices, ReduceDB, ...)
+// under conf.max_mem_mb. Over conf.mem_budget_react_ratio of it, the tier-2
+// redundant clauses are shrunk, memory-hungry inprocessing is skipped and
+// unused capacity is released. Over the budget it does the same, harder.
+// It never stops the solver.
+class MemBudget
+{
+public:
+    explicit MemBudget(Solver* solver);
+
+    enum class Level {ok, tight, over};
+
+    uint64_t used() const;
+    Level level() const;
+
+    // Called from the search loop, shrinks tier-2 once in a while if needed
+    void check_during_search();
+    // Called before inprocessing, shrinks tier-2 and releases capacity if needed
+    void check_before_inprocess();
+    // Whether an inprocessing token is allowed to run at the current level
+    bool allows(const string& token);
+    void print_stats() const;
+
+private:
+    Solver* solver;
+    Level cur = Level::ok; ///< As of the last check
+    uint64_t next_search_check = 0;
+    uint64_t search_check_mult = 1; ///< Doubled while shrinking tier-2 doesn't get us back to ok
+    size_t lev2_after_shrink = 0; ///< Tier-2 size after the last shrink
+    bool warned = false;
+
+    Level update();
+    void shrink_lev2();
+
+    uint64_t num_checks = 0;
+    uint64_t num_lev2_shrinks = 0;
+    uint64_t num_releases = 0;
+    uint64_t num_skipped = 0;
+    uint64_t max_used = 0;
+
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(SolverTest, mem_budget_levels_and_skipping);
+    FRIEND_TEST(SolverTest, mem_budget_shrinks_lev2_and_backs_off);
+    #endif
+};
+
+} //end namespace
+
+#endif //MEMBUDGET_H
@@ -34,8 +34,11 @@ THE SOFTWARE.
 #include <limits>
 #include <cmath>
 #include <functional>
+#include <queue>
+#include <cstring>
 
 #include "occsimplifier.h"
+#include "inprocsched.h"
 #include "clause.h"
 #include "solver.h"
 #include "clausecleaner.h"
@@ -96,6 +99,7 @@ OccSimplifier::OccSimplifier(Solver* _solver):
     , elimed_map_built(false)
 {
     sub_str = new SubsumeStrengthen(this, solver);
+    elimed_store.set_mem_limit(solver->conf.elimed_cls_mem_limitM*1024ULL*1024ULL);
 
     tmp_bin_cl.resize(2);
 }
@@ -126,7 +130,9 @@ void OccSimplifier::save_on_var_memory()
 {
     clauses.clear();
     clauses.shrink_to_fit();
-    elimed_cls_lits.shrink_to_fit();
+    elimed_store.shrink_to_fit();
+    elimed_lits.clear();
+    elimed_lits.shrink_to_fit();
 
     cl_to_free_later.shrink_to_fit();
 
@@ -136,31 +142,26 @@ void OccSimplifier::save_on_var_memory()
 
 void OccSimplifier::print_elimed_clauses_reverse() const
 {
+    vector<Lit> elimed;
     for(vector<ElimedClauses>::const_reverse_iterator
         it = elimed_cls.rbegin(), end = elimed_cls.rend()
         ; it != end
         ; ++it
     ) {
-        size_t at = 1;
+        elimed_store.get(*it, elimed);
         vector<Lit> lits;
-        while(at < it->size()) {
-            Lit l = it->at(at, elimed_cls_lits);
+        for(const Lit l: elimed) {
             if (l == lit_Undef) {
                 cout
-                << "elimed clause (internal number):";
-                for(size_t i = 0; i < it->size(); i++) {
-                    cout << it->at(i, elimed_cls_lits) << " ";
-                }
-                cout << endl;
+                << "elimed clause (internal number):" << lits << endl;
                 lits.clear();
             } else {
                 lits.push_back(l);
             }
-            at++;
         }
 
         cout
-        << "dummy elimed clause for var (internal number) " << it->at(0, elimed_cls_lits).var()
+        << "dummy elimed clause for var (internal number) " << it->on.var()
         << endl;
 
     }
@@ -169,13 +170,11 @@ void OccSimplifier::print_elimed_clauses_reverse() const
 uint32_t OccSimplifier::dump_elimed_clauses(std::ostream* outfile) const
 {
     uint32_t num_cls = 0;
-    for (ElimedClauses elimed: elimed_cls) {
+    vector<Lit> lits;
+    for (const ElimedClauses& elimed: elimed_cls) {
         if (elimed.toRemove) continue;
-        for (size_t i = 0; i < elimed.size(); i++) {
-            //It's elimed on this variable
-            if (i == 0) continue;
-
-            Lit l = elimed.at(i, elimed_cls_lits);
+        elimed_store.get(elimed, lits);
+        for (const Lit l: lits) {
             if (outfile != nullptr) {
                 if (l == lit_Undef) *outfile << " 0" << endl;
                 else *outfile << l << " ";
@@ -196,14 +195,15 @@ bool OccSimplifier::get_elimed_clause_at(uint32_t& at,uint32_t& at2,
             continue;
         }
         is_xor = elimed.is_xor;
+        if (at2 == 0 || elimed_at_lits_of != at) {
+            elimed_store.get(elimed, elimed_at_lits);
+            elimed_at_lits_of = at;
+        }
 
-        while(at2 <  elimed.size()) {
-            //It's elimed on this variable
-            if (at2 == 0) {
-                at2++;
-                continue;
-            }
-            Lit l = elimed.at(at2, elimed_cls_lits);
+        //at2 == 0 was the var it's elimed on
+        if (at2 == 0) at2 = 1;
+        while(at2-1 < elimed_at_lits.size()) {
+            const Lit l = elimed_at_lits[at2-1];
             if (l == lit_Undef) {
                 at2++;
                 return true;
@@ -231,50 +231,209 @@ void OccSimplifier::extend_model(SolutionExtender* extender)
     print_elimed_clauses_reverse();
     #endif
 
+    if (solver->conf.do_incremental_extend && extend_model_incremental(extender)) return;
+
+    const bool cache = solver->conf.do_incremental_extend;
+    if (cache) ext_cache.model_in = solver->model;
+
     //go through in reverse order
     vector<Lit> lits;
     for (long int i = (int)elimed_cls.size()-1; i >= 0; i--) {
-        ElimedClauses* it = &elimed_cls[i];
-        if (it->toRemove) continue;
+        if (elimed_cls[i].toRemove) continue;
+        extend_elimed_cls(i, extender, lits);
+    }
+    if (cache) {
+        ext_cache.model_out = solver->model;
+        ext_cache.num_replaced = solver->varReplacer->get_num_replaced_vars();
+        ext_cache.readers.clear();
+        ext_cache.readers_built = false;
+        ext_cache.valid = !ext_cache.unusable;
+        ext_cache.num_full++;
+    }
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [extend] Extended " << elimed_cls.size() << " var-elim clauses" << endl;
+    }
+}
 
-        Lit elimed_on = solver->varReplacer->get_lit_replaced_with_outer(it->at(0, elimed_cls_lits));
-        size_t at = 1;
-        bool satisfied = false;
-        lits.clear();
-        while(at < it->size()) {
-            //built clause, reached marker, "lits" is now valid
-            if (it->at(at, elimed_cls_lits) == lit_Undef) {
-                if (!satisfied) {
-                    [[maybe_unused]] bool var_set;
-                    if (!it->is_xor) var_set = extender->add_cl(lits, elimed_on.var());
-                    else var_set =extender->add_xor_cl(lits, elimed_on.var());
-
-
-                    #ifndef DEBUG_VARELIM
-                    //all should be satisfied in fact
-                    //no need to go any further
-                    if (var_set) break;
-                    #endif
-                }
-                satisfied = false;
-                lits.clear();
+// Sets the value of the var elim_cls[at] is eliminated on, and the values of
+// the vars replaced by it
+void OccSimplifier::extend_elimed_cls(const uint32_t at_cls, SolutionExtender* extender, vector<Lit>& lits)
+{
+    ElimedClauses* it = &elimed_cls[at_cls];
+    Lit elimed_on = solver->varReplacer->get_lit_replaced_with_outer(it->on);
+    elimed_store.get(*it, elimed_lits);
+    bool satisfied = false;
+    lits.clear();
+    for(const Lit elimed_l: elimed_lits) {
+        //built clause, reached marker, "lits" is now valid
+        if (elimed_l == lit_Undef) {
+            if (!satisfied) {
+                [[maybe_unused]] bool var_set;
+                if (!it->is_xor) var_set = extender->add_cl(lits, elimed_on.var());
+                else var_set =extender->add_xor_cl(lits, elimed_on.var());
+
+
+                #ifndef DEBUG_VARELIM
+                //all should be satisfied in fact
+                //no need to go any further
+                if (var_set) break;
+                #endif
+            }
+            satisfied = false;
+            lits.clear();
 
-            //Building clause, "lits" is not yet valid
-            } else if (!satisfied) {
-                Lit l = it->at(at, elimed_cls_lits);
-                l = solver->varReplacer->get_lit_replaced_with_outer(l);
-                lits.push_back(l);
+        //Building clause, "lits" is not yet valid
+        } else if (!satisfied) {
+            const Lit l = solver->varReplacer->get_lit_replaced_with_outer(elimed_l);
+            lits.push_back(l);
+
+            //Elimed clause can be skipped, it's satisfied
+            if (!it->is_xor && solver->model_value(l) == l_True) satisfied = true;
+        }
+    }
+    extender->dummy_elimed(elimed_on.var());
+}
 
-                //Elimed clause can be skipped, it's satisfied
-                if (!it->is_xor && solver->model_value(l) == l_True) satisfied = true;
+// Indexes which elimed clauses read which var. An elimed clause that reads a
+// var that is only set after it has been walked makes the cache unusable.
+bool OccSimplifier::build_extend_readers()
+{
+    const size_t n = solver->nVarsOuter();
+    const uint32_t never = numeric_limits<uint32_t>::max();
+    auto& elimed_on = ext_cache.elimed_on;
+    elimed_on.assign(elimed_cls.size(), never);
+
+    // A var may have several elimed clause sets (e.g. blocked clauses). They
+    // are re-walked together, so they must follow each other on the stack.
+    // set_at[v] is the last (i.e. first walked) set of var v
+    vector<uint32_t> set_at(n, never);
+    uint32_t last_var = never;
+    for(uint32_t i = 0; i < elimed_cls.size(); i++) {
+        if (elimed_cls[i].toRemove) continue;
+        const uint32_t v = solver->varReplacer->get_var_replaced_with_outer(elimed_cls[i].on.var());
+        if (set_at[v] != never && last_var != v) return false;
+        elimed_on[i] = v;
+        set_at[v] = i;
+        last_var = v;
+    }
+
+    auto& readers = ext_cache.readers;
+    readers.clear();
+    readers.resize(n);
+    for(uint32_t i = 0; i < elimed_cls.size(); i++) {
+        const ElimedClauses& e = elimed_cls[i];
+        if (e.toRemove) continue;
+        const uint32_t top = set_at[elimed_on[i]];
+        elimed_store.get(e, elimed_lits);
+        for(const Lit l: elimed_lits) {
+            if (l == lit_Undef) continue;
+            const uint32_t v = solver->varReplacer->get_var_replaced_with_outer(l.var());
+            if (v == elimed_on[i]) continue;
+            if (ext_cache.model_in[v] == l_Undef && (set_at[v] == never || set_at[v] < top)) {
+                readers.clear();
+                return false;
             }
-            at++;
+            if (readers[v].empty() || readers[v].back() != top) readers[v].push_back(top);
         }
-        extender->dummy_elimed(elimed_on.var());
     }
-    if (solver->conf.verbosity >= 2) {
-        cout << "c [extend] Extended " << elimed_cls.size() << " var-elim clauses" << endl;
+    ext_cache.in_todo.assign(elimed_cls.size(), 0);
+    ext_cache.readers_built = true;
+    return true;
+}
+
+// Re-extends starting from the previous extension. Only elimed clauses that
+// read a var whose value differs from the previous extension are re-walked,
+// in the same (reverse) order as a full extension would walk them. Returns
+// false if a full extension is needed.
+bool OccSimplifier::extend_model_incremental(SolutionExtender* extender)
+{
+    auto& model = solver->model;
+    const size_t n = model.size();
+    if (!ext_cache.valid
+        || ext_cache.model_in.size() != n
+        || ext_cache.num_replaced != solver->varReplacer->get_num_replaced_vars()
+    ) return false;
+
+    if (!ext_cache.readers_built && !build_extend_readers()) {
+        ext_cache.unusable = true;
+        ext_cache.valid = false;
+        return false;
+    }
+
+    // Find the changed inputs. Mostly the models are the same, so compare
+    // whole blocks with memcmp first, which is vectorized
+    static_assert(sizeof(lbool) == 1, "lbool must be a byte for memcmp");
+    auto& changed = ext_cache.changed;
+    changed.clear();
+    const lbool* in = model.data();
+    const lbool* old_in = ext_cache.model_in.data();
+    constexpr size_t block = 64;
+    for(size_t b = 0; b < n; b += block) {
+        const size_t end = std::min(n, b+block);
+        if (memcmp(in+b, old_in+b, end-b) == 0) continue;
+        for(size_t v = b; v < end; v++) {
+            if (in[v] == old_in[v]) continue;
+            // The set of vars to extend changed, can't use the cache
+            if ((in[v] == l_Undef) != (old_in[v] == l_Undef)) return false;
+            changed.push_back(v);
+        }
+    }
+
+    // Everything not re-walked keeps its previous value
+    const lbool* old_out = ext_cache.model_out.data();
+    for(size_t v = 0; v < n; v++) {
+        if (model[v] == l_Undef) model[v] = old_out[v];
+    }
+    for(const auto& v: changed) ext_cache.model_in[v] = model[v];
+
+    std::priority_queue<uint32_t> todo;
+    auto& in_todo = ext_cache.in_todo;
+    auto add_readers = [&](const uint32_t v) {
+        for(const auto& i: ext_cache.readers[v]) {
+            if (in_todo[i]) continue;
+            in_todo[i] = 1;
+            todo.push(i);
+        }
+    };
+    for(const auto& v: changed) add_readers(v);
+
+    vector<Lit> lits;
+    uint64_t reextended = 0;
+    while(!todo.empty()) {
+        const uint32_t i = todo.top();
+        todo.pop();
+        in_todo[i] = 0;
+        reextended++;
+
+        const uint32_t v = ext_cache.elimed_on[i];
+        const lbool old_val = model[v];
+        solver->varReplacer->unset_model(v);
+        for(long int k = i; k >= 0; k--) {
+            if (elimed_cls[k].toRemove) continue;
+            if (ext_cache.elimed_on[k] != v) break;
+            extend_elimed_cls(k, extender, lits);
+        }
+        if (model[v] != old_val) add_readers(v);
+    }
+
+    #ifdef SLOW_DEBUG
+    for(const auto& e: elimed_cls) {
+        if (e.toRemove || e.is_xor) continue;
+        bool sat = false;
+        elimed_store.get(e, elimed_lits);
+        for(const Lit l: elimed_lits) {
+            if (l == lit_Undef) {assert(sat); sat = false; continue;}
+            sat |= solver->model_value(solver->varReplacer->get_lit_replaced_with_outer(l)) == l_True;
+        }
     }
+    #endif
+
+    ext_cache.model_out = model;
+    ext_cache.num_incremental++;
+    ext_cache.num_reextended += reextended;
+    verb_print(2, "[extend] incremental, changed inputs: " << changed.size()
+        << " re-extended: " << reextended << " of " << elimed_cls.size() << " var-elim clause sets");
+    return true;
 }
 
 void OccSimplifier::unlink_clause(
@@ -2258,7 +2417,6 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
         assert(solver->decisionLevel() == 0);
         assert(cl_to_free_later.empty());
         assert(solver->watches.get_smudged_list().empty());
-        set_limits();
 
         #ifdef SLOW_DEBUG
         #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
@@ -2286,6 +2444,8 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
             cout << "c --> Executing OCC strategy token: " << token << '\n';
             *solver->frat << __PRETTY_FUNCTION__ << " Executing OCC strategy token:" << token.c_str() << "\n";
         }
+        if (!token.empty()) solver->inproc_sched->start(token);
+        set_limits();
 
         if (token == "occ-backw-sub-str") {
             backward_sub_str();
@@ -2338,6 +2498,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
              cout << "ERROR: occur strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (!token.empty()) solver->inproc_sched->finish(token);
         CHECK_N_OCCUR_DO(check_n_occur());
         SLOW_DEBUG_DO(check_cls_sanity());
         SLOW_DEBUG_DO(solver->check_no_removed_or_freed_cl_in_watch());
@@ -2980,23 +3141,21 @@ bool OccSimplifier::uneliminate(uint32_t var)
     const bool is_xor = elimed_cls[at_elimed_cls].is_xor;
     elimed_cls[at_elimed_cls].toRemove = true;
     can_remove_elimed_clauses = true;
-    assert(elimed_cls[at_elimed_cls].at(0, elimed_cls_lits).var() == var);
+    ext_cache.invalidate();
+    assert(elimed_cls[at_elimed_cls].on.var() == var);
 
-    //Re-insert into Solver
+    //Re-insert into Solver. Adding clauses may uneliminate other vars, so copy
+    vector<Lit> elimed;
+    elimed_store.get(elimed_cls[at_elimed_cls], elimed);
     #ifdef VERBOSE_DEBUG_RECONSTRUCT
     cout
-    << "Uneliminating cl ";
-    for(size_t i=0; i< elimedClauses[at_elimed_cls].size(); i++){
-        cout << elimedClauses[at_elimed_cls].at(i, elimed_cls_lits) << " ";
-    }
-    cout << " on var " << var+1
+    << "Uneliminating cl " << elimed
+    << " on var " << var+1
     << endl;
     #endif
 
     vector<Lit> lits;
-    size_t bat = 1;
-    while(bat < elimed_cls[at_elimed_cls].size()) {
-        Lit l = elimed_cls[at_elimed_cls].at(bat, elimed_cls_lits);
+    for(const Lit l: elimed) {
         if (l == lit_Undef) {
             if (is_xor) solver->add_xor_clause_outside(lits, true);
             else solver->add_clause_outside(lits, false, true);
@@ -3005,7 +3164,6 @@ bool OccSimplifier::uneliminate(uint32_t var)
         } else {
             lits.push_back(l);
         }
-        bat++;
     }
 
     return solver->okay();
@@ -3023,9 +3181,8 @@ void OccSimplifier::remove_by_frat_recently_elimed_clauses(size_t origElimedSize
     vector<Lit> lits;
     for(size_t i = origElimedSize; i < elimed_cls.size(); i++) {
         lits.clear();
-        size_t at = 1;
-        while(at < elimed_cls[i].size()) {
-            const Lit l = elimed_cls[i].at(at, elimed_cls_lits);
+        elimed_store.get(elimed_cls[i], elimed_lits);
+        for(const Lit l: elimed_lits) {
             if (l == lit_Undef) {
                 const int32_t id = newly_elimed_cls_IDs[at_ID++];
                 if (elimed_cls[i].is_xor) *solver->frat << delx << id << lits << fin;
@@ -3034,7 +3191,6 @@ void OccSimplifier::remove_by_frat_recently_elimed_clauses(size_t origElimedSize
             } else {
                 lits.push_back(solver->map_outer_to_inter(l));
             }
-            at++;
         }
     }
     newly_elimed_cls_IDs.clear();
@@ -3046,7 +3202,7 @@ void OccSimplifier::build_elimed_map()
     blk_var_to_cls.resize(solver->nVarsOuter(), numeric_limits<uint32_t>::max());
     for(size_t i = 0; i < elimed_cls.size(); i++) {
         const ElimedClauses& elimed = elimed_cls[i];
-        uint32_t elimedon = elimed.at(0, elimed_cls_lits).var();
+        uint32_t elimedon = elimed.on.var();
         assert(elimedon < blk_var_to_cls.size());
         blk_var_to_cls[elimedon] = i;
     }
@@ -3100,6 +3256,11 @@ void OccSimplifier::finish_up(size_t origTrailSize) {
     }
 
     if (solver->ok) check_elimed_vars_are_unassignedAndStats();
+    verb_print(2, "[occ] elimed cls store lits added: " << print_value_kilo_mega(elimed_store.num_lits)
+        << " bytes/lit: " << std::setprecision(2) << std::fixed
+        << float_div(elimed_store.num_bytes, elimed_store.num_lits)
+        << " bytes: " << print_value_kilo_mega(elimed_store.size())
+        << " spilled bytes: " << print_value_kilo_mega(elimed_store.spilled_bytes()));
 
     //Let's just clean up ourselves a bit
     clauses.clear();
@@ -3214,17 +3375,8 @@ void OccSimplifier::set_limits()
 void OccSimplifier::clean_elimed_cls()
 {
     assert(solver->decisionLevel() == 0);
-    vector<ElimedClauses>::iterator i = elimed_cls.begin();
-    vector<ElimedClauses>::iterator j = elimed_cls.begin();
-
-    uint64_t i_lits = 0;
-    uint64_t j_lits = 0;
-    for (vector<ElimedClauses>::iterator
-        end = elimed_cls.end()
-        ; i != end
-        ; ++i
-    ) {
-        const uint32_t elimed_on = solver->map_outer_to_inter(i->at(0, elimed_cls_lits).var());
+    for (const ElimedClauses& e: elimed_cls) {
+        const uint32_t elimed_on = solver->map_outer_to_inter(e.on.var());
         if (solver->varData[elimed_on].removed == Removed::elimed
             && solver->value(elimed_on) != l_Undef
         ) {
@@ -3233,36 +3385,17 @@ void OccSimplifier::clean_elimed_cls()
             assert(false); exit(-1);
         }
 
-        if (i->toRemove) {
-            elimed_map_built = false;
-            i_lits += i->size();
-            assert(i_lits == i->end);
-            i->start = numeric_limits<uint64_t>::max();
-            i->end = numeric_limits<uint64_t>::max();
-        } else {
-            assert(solver->varData[elimed_on].removed == Removed::elimed);
-
-            //beware we might change this
-            const size_t sz = i->size();
+        if (e.toRemove) elimed_map_built = false;
+        else assert(solver->varData[elimed_on].removed == Removed::elimed);
+    }
 
-            //don't copy if we don't need to
-            if (!elimed_map_built) {
-                for(size_t x = 0; x < sz; x++) {
-                    elimed_cls_lits[j_lits++] = elimed_cls_lits[i_lits++];
-                }
-            } else {
-                i_lits += sz;
-                j_lits += sz;
-            }
-            assert(i_lits == i->end);
-            i->start = j_lits-sz;
-            i->end   = j_lits;
-            *j++ = *i;
-        }
+    //don't move anything if we don't need to
+    if (!elimed_map_built) {
+        elimed_store.remove_marked(elimed_cls);
+        elimed_at_lits_of = numeric_limits<uint32_t>::max();
     }
-    elimed_cls_lits.resize(j_lits);
-    elimed_cls.resize(elimed_cls.size()-(i-j));
     can_remove_elimed_clauses = false;
+    ext_cache.invalidate();
 }
 
 void OccSimplifier::rem_cls_from_watch_due_to_varelim(const Lit lit , bool add_to_block) {
@@ -3352,10 +3485,9 @@ void OccSimplifier::add_clause_to_blck(const vector<Lit>& lits, const int32_t id
 
     vector<Lit> lits_outer = lits;
     solver->map_inter_to_outer(lits_outer);
-    for(Lit l: lits_outer) elimed_cls_lits.push_back(l);
-    elimed_cls_lits.push_back(lit_Undef);
-    elimed_cls.back().end = elimed_cls_lits.size();
+    elimed_store.add_clause(elimed_cls.back(), lits_outer);
     newly_elimed_cls_IDs.push_back(id);
+    ext_cache.invalidate();
 }
 
 void OccSimplifier::add_picosat_cls(
@@ -4679,9 +4811,9 @@ void OccSimplifier::set_var_as_eliminated(const uint32_t var)
 
 void OccSimplifier::create_dummy_elimed_clause(const Lit lit, bool is_xor)
 {
-    elimed_cls_lits.push_back(solver->map_inter_to_outer(lit));
-    elimed_cls.push_back(ElimedClauses(elimed_cls_lits.size()-1, elimed_cls_lits.size(), is_xor));
+    elimed_cls.push_back(ElimedClauses(solver->map_inter_to_outer(lit), elimed_store.size(), is_xor));
     elimed_map_built = false;
+    ext_cache.invalidate();
 }
 
 bool OccSimplifier::occ_based_lit_rem(uint32_t var, uint32_t& removed) {
@@ -5247,7 +5379,7 @@ size_t OccSimplifier::mem_used() const
     b += added_long_cl.capacity()*sizeof(ClOffset);
     b += sub_str->mem_used();
     b += elimed_cls.capacity()*sizeof(ElimedClauses);
-    b += elimed_cls_lits.capacity()*sizeof(Lit);
+    b += elimed_store.mem_used();
     b += blk_var_to_cls.size()*sizeof(uint32_t);
     b += velim_order.mem_used();
     b += varElimComplexity.capacity()*sizeof(int)*2;
@@ -33,6 +33,10 @@ THE SOFTWARE.
 #include "touchlist.h"
 #include "watched.h"
 #include "watcharray.h"
+#include "elimed_cls_store.h"
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
 struct PicoSAT;
 
 namespace CMSat {
@@ -48,24 +52,6 @@ class Solver;
 class SubsumeStrengthen;
 class GateFinder;
 
-struct ElimedClauses {
-    ElimedClauses() = default;
-    explicit ElimedClauses(size_t _start, size_t _end, bool _is_xor):
-        start(_start) , end(_end),  is_xor(_is_xor) {}
-    const Lit& at(const uint64_t at, const vector<Lit>& elimed_cls_lits) const {
-        return elimed_cls_lits[start+at];
-    }
-    Lit& at(const uint64_t at, vector<Lit>& elimed_cls_lits) {
-        return elimed_cls_lits[start+at];
-    }
-
-    uint64_t size() const { return end-start; }
-    uint64_t start;
-    uint64_t end;
-    bool toRemove = false;
-    bool is_xor = false;
-};
-
 struct BVEStats
 {
     uint64_t numCalls = 0;
@@ -556,8 +542,15 @@ private:
 
     /////////////////////
     //Elimed clause elimination
-    vector<Lit> elimed_cls_lits;
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(SolverTest, elimed_cls_in_memory_under_default_limit);
+    FRIEND_TEST(SolverTest, elimed_cls_spill_under_tiny_limit);
+    #endif
+    ElimedClsStore elimed_store;
     vector<ElimedClauses> elimed_cls; ///<maps var(outer!!) to postion in elimedClauses
+    vector<Lit> elimed_lits; ///<temporary, decoded clauses of an elimed_cls entry
+    mutable vector<Lit> elimed_at_lits; ///<decoded clauses of elimed_cls[elimed_at_lits_of]
+    mutable uint32_t elimed_at_lits_of = std::numeric_limits<uint32_t>::max();
     vector<uint32_t> blk_var_to_cls;
     vector<int32_t> newly_elimed_cls_IDs; // temporary storage for newly elimed cls' IDs
     bool elimed_map_built;
@@ -565,6 +558,33 @@ private:
     void clean_elimed_cls();
     bool can_remove_elimed_clauses = false;
 
+    /////////////////////
+    //Incremental solution extension. Remembers the previous extension, so
+    //the next one only needs to re-walk the elimed clauses whose inputs changed
+    struct ExtendCache {
+        bool valid = false; ///< elimed_cls and var replacement unchanged since last extension
+        bool readers_built = false;
+        bool unusable = false; ///< some elimed clause reads an unset var
+        size_t num_replaced = 0;
+        vector<lbool> model_in; ///< model (outer) before walking elimed_cls
+        vector<lbool> model_out; ///< model (outer) after walking elimed_cls
+        vector<vector<uint32_t>> readers; ///< var (outer) -> elimed_cls reading it
+        vector<uint32_t> elimed_on; ///< elimed_cls -> var (outer) it sets
+        vector<char> in_todo;
+        vector<uint32_t> changed;
+        uint64_t num_full = 0;
+        uint64_t num_incremental = 0;
+        uint64_t num_reextended = 0;
+        void invalidate() { valid = false; unusable = false; }
+    };
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(SolverTest, extend_incremental_same_as_full);
+    #endif
+    ExtendCache ext_cache;
+    void extend_elimed_cls(const uint32_t at, SolutionExtender* extender, vector<Lit>& lits);
+    bool extend_model_incremental(SolutionExtender* extender);
+    bool build_extend_readers();
+
     ///Stats from this run
     Stats runStats;
 
@@ -588,6 +608,7 @@ void OccSimplifier::unserialize_elimed_cls(T& ar)
 {
     ar >> eClsLits;
     ar >> elimedClauses;
+    ext_cache.invalidate();
 }
 
 template<class T>
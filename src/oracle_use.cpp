@@ -22,6 +22,9 @@ THE SOFTWARE.
 
 #include "solver.h"
 #include "oracle/oracle.h"
+#include <limits>
+#include <memory>
+#include <thread>
 
 using namespace CMSat;
 
@@ -74,6 +77,80 @@ vector<vector<int>> Solver::get_irred_cls_for_oracle() const
     return clauses;
 }
 
+namespace {
+struct OracleVivifWorker {
+    OracleVivifWorker(int nvars, const vector<vector<int>>& cls, size_t _at, size_t _end) :
+        oracle(nvars, cls, {}), at(_at), end(_end) {}
+
+    sspp::oracle::Oracle oracle;
+    size_t at; // next clause to vivify
+    size_t end; // one past the last clause of our range
+    bool out_of_budget = false;
+    bool unsat = false;
+    vector<size_t> strengthened; // clauses strengthened during this round
+    vector<vector<int>> to_import; // clauses strengthened by the other workers
+};
+
+// Vivifies clauses[w.at..w.end). Only this worker touches these clauses, so
+// it can run concurrently with the other workers. Returns after round_mems
+// mems (or past the deadline) so the strengthened clauses can be exchanged.
+void oracle_vivif_range(OracleVivifWorker& w, vector<vector<int>>& clauses,
+    const int64_t round_mems, const int64_t max_mems, const double deadline)
+{
+    for(const auto& cl: w.to_import) w.oracle.AddClauseIfNeededAndStr(cl, true);
+    w.to_import.clear();
+
+    const int64_t round_end = w.oracle.getStats().mems + round_mems;
+    for (; w.at < w.end; w.at++) {
+        auto& cl = clauses[w.at];
+        for (int j = 0; j < (int)cl.size(); j++) {
+            if (w.oracle.getStats().mems > max_mems) {w.out_of_budget = true; return;}
+            auto assump = negate(cl);
+            swapdel(assump, j);
+            // A single call cannot be interrupted, so with a wall-clock
+            // budget no call may take longer than a round
+            int64_t call_mems = std::min<int64_t>(500LL*1000LL*1000LL,
+                max_mems - w.oracle.getStats().mems);
+            if (deadline != std::numeric_limits<double>::max())
+                call_mems = std::min(call_mems, round_mems);
+            auto ret = w.oracle.Solve(assump, true, call_mems);
+            if (ret.isUnknown()) {w.out_of_budget = true; return;}
+            if (ret.isFalse()) {
+                sort(assump.begin(), assump.end());
+                auto clause = negate(assump);
+                w.oracle.AddClauseIfNeededAndStr(clause, true);
+                cl = clause;
+                j = -1; //start from beginning
+                if (w.strengthened.empty() || w.strengthened.back() != w.at)
+                    w.strengthened.push_back(w.at);
+                if (clause.empty()) {w.unsat = true; return;}
+            }
+        }
+        if (w.oracle.getStats().mems > round_end || real_time_sec() > deadline) {
+            w.at++;
+            return;
+        }
+    }
+}
+}
+
+vector<vector<int>> Solver::get_irred_cls_for_oracle_ordered() const
+{
+    vector<vector<int>> clauses;
+    vector<int> tmp;
+    for(const auto& c: order_clauses_for_oracle()) {
+        tmp.clear();
+        if (!c.binary) {
+            for(auto const& l: *cl_alloc.ptr(c.off)) tmp.push_back(orclit(l));
+        } else {
+            tmp.push_back(orclit(c.bin.l1));
+            tmp.push_back(orclit(c.bin.l2));
+        }
+        clauses.push_back(tmp);
+    }
+    return clauses;
+}
+
 bool Solver::oracle_vivif(bool& finished)
 {
     assert(!frat->enabled());
@@ -85,40 +162,67 @@ bool Solver::oracle_vivif(bool& finished)
     if (!okay()) return okay();
     if (nVars() < 10) return okay();
     double my_time = cpuTime();
+    const double my_real_time = real_time_sec();
 
-    auto clauses = get_irred_cls_for_oracle();
+    // With multiple workers, related clauses should end up in the same range
+    const uint32_t num_workers = std::max<uint32_t>(1, conf.oracle_vivif_threads);
+    auto clauses = (num_workers > 1) ? get_irred_cls_for_oracle_ordered() : get_irred_cls_for_oracle();
     detach_and_free_all_irred_cls();
 
-    sspp::oracle::Oracle oracle(nVars(), clauses, {});
-    oracle.SetVerbosity(conf.verbosity);
-    bool sat = false;
-    for (int i = 0; i < (int)clauses.size(); i++) {
-        for (int j = 0; j < (int)clauses[i].size(); j++) {
-            if (oracle.getStats().mems > 1600LL*1000LL*1000LL) goto end;
-            auto assump = negate(clauses[i]);
-            swapdel(assump, j);
-            auto ret = oracle.Solve(assump, true, 500LL*1000LL*1000LL);
-            if (ret.isUnknown()) {
-                goto end;
+    vector<std::unique_ptr<OracleVivifWorker>> workers;
+    for(uint32_t i = 0; i < num_workers; i++) {
+        const size_t at = (clauses.size()*i)/num_workers;
+        const size_t end = (clauses.size()*(i+1))/num_workers;
+        workers.emplace_back(new OracleVivifWorker(nVars(), clauses, at, end));
+        workers.back()->oracle.SetVerbosity(i == 0 ? conf.verbosity : 0);
+    }
+
+    const int64_t max_mems = 1600LL*1000LL*1000LL;
+    const int64_t round_mems = conf.oracle_vivif_sync_memsM*1000LL*1000LL;
+    const double deadline = (conf.oracle_vivif_max_time > 0) ?
+        my_real_time + conf.oracle_vivif_max_time : std::numeric_limits<double>::max();
+    uint32_t rounds = 0;
+    bool unsat = false;
+    while(true) {
+        rounds++;
+        if (num_workers == 1) {
+            oracle_vivif_range(*workers[0], clauses, round_mems, max_mems, deadline);
+        } else {
+            vector<std::thread> threads;
+            for(auto& w: workers) {
+                if (w->out_of_budget || w->at >= w->end) continue;
+                threads.push_back(std::thread(oracle_vivif_range,
+                    std::ref(*w), std::ref(clauses), round_mems, max_mems, deadline));
             }
-            if (ret.isFalse()) {
-                sort(assump.begin(), assump.end());
-                auto clause = negate(assump);
-                oracle.AddClauseIfNeededAndStr(clause, true);
-                clauses[i] = clause;
-                j = -1; //start from beginning
-                if (clause.empty()) {
-                    ok = false;
-                    return false;
-                }
-            } else if(!sat) {
-                sat = true;
+            for(auto& t: threads) t.join();
+        }
+
+        // Merge: every worker gets the clauses strengthened by the others
+        bool all_done = true;
+        for(auto& w: workers) {
+            unsat |= w->unsat;
+            if (!w->out_of_budget && w->at < w->end) all_done = false;
+            for(auto& w2: workers) {
+                if (w2 == w || w2->out_of_budget || w2->at >= w2->end) continue;
+                for(const auto& at: w->strengthened) w2->to_import.push_back(clauses[at]);
             }
+            //Cleared here, a finished worker doesn't run again
+            w->strengthened.clear();
+        }
+        if (unsat) {
+            ok = false;
+            return false;
+        }
+        if (all_done) break;
+        if (real_time_sec() > deadline) {
+            verb_print(1, "[oracle-vivif] wall-clock budget exhausted after round " << rounds);
+            break;
         }
     }
-    finished |= true;
+    bool vivif_finished = true;
+    for(const auto& w: workers) vivif_finished &= (!w->out_of_budget && w->at >= w->end);
+    finished |= vivif_finished;
 
-    end:
     vector<Lit> tmp2;
     for(const auto& cl: clauses) {
         tmp2.clear();
@@ -129,7 +233,7 @@ bool Solver::oracle_vivif(bool& finished)
     }
 
     if (conf.oracle_get_learnts) {
-        for (const auto& cl: oracle.GetLearnedClauses()) {
+        for (const auto& w: workers) for (const auto& cl: w->oracle.GetLearnedClauses()) {
             tmp2.clear();
             for(const auto& l: cl) tmp2.push_back(orc_to_lit(l));
             ClauseStats s;
@@ -142,12 +246,23 @@ bool Solver::oracle_vivif(bool& finished)
         }
     }
 
-    verb_print(1, "[oracle-vivif] finished: " << finished
-            << " cache-used: " << oracle.getStats().cache_useful
-            << " cache-added: " << oracle.getStats().cache_added
-            << " learnt-units: " << oracle.getStats().learned_units
+    sspp::oracle::Stats st;
+    for (const auto& w: workers) {
+        st.mems += w->oracle.getStats().mems;
+        st.cache_useful += w->oracle.getStats().cache_useful;
+        st.cache_added += w->oracle.getStats().cache_added;
+        st.learned_units += w->oracle.getStats().learned_units;
+    }
+    verb_print(1, "[oracle-vivif] finished: " << vivif_finished
+            << " workers: " << num_workers
+            << " rounds: " << rounds
+            << " mems: " << print_value_kilo_mega(st.mems)
+            << " cache-used: " << st.cache_useful
+            << " cache-added: " << st.cache_added
+            << " learnt-units: " << st.learned_units
             << " finished (vivif or backbone): " << finished
-            << " T: " << std::setprecision(2) << (cpuTime()-my_time));
+            << " T: " << std::setprecision(2) << (cpuTime()-my_time)
+            << " wallT: " << std::setprecision(2) << (real_time_sec()-my_real_time));
     return solver->okay();
 }
 
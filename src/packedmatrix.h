@@ -57,6 +57,11 @@ public:
         #endif
     }
 
+    size_t mem_used() const
+    {
+        return sizeof(int64_t)*numRows*(numCols+1);
+    }
+
     void resize(const uint32_t num_rows, uint32_t num_cols)
     {
         num_cols = num_cols / 64 + (bool)(num_cols % 64);
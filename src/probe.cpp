@@ -24,9 +24,103 @@ THE SOFTWARE.
 #include "solver.h"
 #include <random>
 #include "varreplacer.h"
+#include "binimplgraph.h"
 
 using namespace CMSat;
 
+namespace {
+
+// Propagates up to 32 variables in both polarities at once over the binary
+// implication graph. Bit 2k of mask[lit] is set when vars[k] implies lit,
+// bit 2k+1 when ~vars[k] does. Reachability in the implication graph is
+// exactly what bin-only propagation computes, so a probe that learns
+// nothing here would learn nothing in probe_inter<true>() either.
+struct BitProber {
+    static constexpr uint64_t even = 0x5555555555555555ULL;
+
+    explicit BitProber(const uint32_t num_vars) :
+        mask(num_vars*2, 0)
+        , in_queue(num_vars*2, 0)
+        , batch_bit(num_vars, 0)
+    {}
+
+    // Returns bit k set if vars[from+k] is failed in either polarity, has a
+    // literal implied by both polarities, or is equivalent to some other
+    // literal. Work done is added to bogoprops.
+    uint32_t run(const vector<uint32_t>& vars, const size_t from, const size_t to,
+        int64_t& bogoprops)
+    {
+        assert(to - from <= 32);
+        for(size_t k = from; k < to; k++) {
+            const uint64_t bits = 3ULL << (2*(k-from));
+            batch_bit[vars[k]] = bits;
+            add(Lit(vars[k], false).toInt(), bits & even);
+            add(Lit(vars[k], true).toInt(), bits & ~even);
+        }
+
+        for(size_t i = 0; i < queue.size(); i++) {
+            const uint32_t node = queue[i];
+            in_queue[node] = 0;
+            const uint64_t m = mask[node];
+            bogoprops += graph.num_succ(node)/4 + 1;
+            for(const uint32_t* it = graph.begin(node), *end = graph.end(node)
+                ; it != end
+                ; it++
+            ) {
+                if ((mask[*it] | m) != mask[*it]) {
+                    add(*it, m);
+                }
+            }
+        }
+        queue.clear();
+
+        uint64_t failed = 0;
+        uint64_t found = 0;
+        for(const uint32_t node: touched) {
+            const uint64_t pos = mask[node];
+            const uint64_t neg = mask[node^1];
+            failed |= pos & neg;
+            //implied by both polarities of the probe
+            found |= pos & (pos >> 1) & even;
+            //node implied by the probe, ~node by its negation -- unless
+            //node is the probe itself
+            found |= pos & (neg >> 1) & even & ~batch_bit[node>>1];
+        }
+        found |= (failed | (failed >> 1)) & even;
+
+        for(const uint32_t node: touched) mask[node] = 0;
+        touched.clear();
+        for(size_t k = from; k < to; k++) batch_bit[vars[k]] = 0;
+
+        uint32_t ret = 0;
+        for(size_t k = 0; k < to - from; k++) {
+            if (found & (1ULL << (2*k))) ret |= 1U << k;
+        }
+        return ret;
+    }
+
+    BinImplGraph graph;
+
+private:
+    void add(const uint32_t node, const uint64_t m)
+    {
+        if (mask[node] == 0) touched.push_back(node);
+        mask[node] |= m;
+        if (!in_queue[node]) {
+            in_queue[node] = 1;
+            queue.push_back(node);
+        }
+    }
+
+    vector<uint64_t> mask;
+    vector<char> in_queue;
+    vector<uint64_t> batch_bit; //var -> its two bits, if probed in this batch
+    vector<uint32_t> queue;
+    vector<uint32_t> touched;
+};
+
+}
+
 bool Solver::full_probe(const bool bin_only)
 {
     assert(okay());
@@ -50,10 +144,33 @@ bool Solver::full_probe(const bool bin_only)
     }
     std::shuffle(vars.begin(), vars.end(), mtrand);
 
-    for(auto const& v: vars) {
+    //Bin-only probes are first filtered 32 variables at a time
+    const bool use_bits = bin_only && conf.bit_parallel_probe;
+    std::unique_ptr<BitProber> bits;
+    uint32_t interesting = 0;
+    uint64_t filtered = 0;
+    if (use_bits) {
+        bits = std::make_unique<BitProber>(nVars());
+        propStats.bogoProps += bits->graph.build(this)/4;
+    }
+
+    for(size_t at = 0; at < vars.size(); at++) {
+        const uint32_t v = vars[at];
         if ((int64_t)solver->propStats.bogoProps > start_bogoprops + bogoprops_to_use)
             break;
 
+        if (use_bits) {
+            if (at % 32 == 0) {
+                int64_t props = 0;
+                interesting = bits->run(vars, at, std::min(at+32, vars.size()), props);
+                propStats.bogoProps += props;
+            }
+            if (!(interesting & (1U << (at % 32)))) {
+                filtered++;
+                continue;
+            }
+        }
+
         uint32_t min_props;
         Lit l(v, false);
 
@@ -82,6 +199,7 @@ bool Solver::full_probe(const bool bin_only)
 
     cleanup:
     std::fill(seen2.begin(), seen2.end(), 0);
+    bits.reset();
 
     const double time_used = cpuTime() - my_time;
     const double time_remain = 1.0-float_div(
@@ -94,6 +212,7 @@ bool Solver::full_probe(const bool bin_only)
         << " set: "
         << (orig_num_free_vars - solver->get_num_free_vars())
         << " repl: " << (varReplacer->get_num_replaced_vars() - orig_repl)
+        << " filtered: " << filtered
         << solver->conf.print_times(time_used,  time_out, time_remain));
 
 
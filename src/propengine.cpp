@@ -163,16 +163,25 @@ PropBy PropEngine::gauss_jordan_elim(const Lit p, const uint32_t currLevel)
 
     if (gmatrices.empty() && xorclauses.empty()) return PropBy();
 
-    // reset gqueuedata and update set vars in gmatrices
-    for(uint32_t i = 0; i < gqueuedata.size(); i++) {
-        if (gqueuedata[i].disabled || !gmatrices[i]->is_initialized()) continue;
-        gqueuedata[i].reset();
-        gmatrices[i]->update_cols_vals_set();
+    // Only the matrices watching pv are touched. All of them are reset and
+    // brought up to date with the trail here, before any of them can
+    // enqueue, so unrelated matrices cost nothing
+    assert(gwatches.size() > pv);
+    vec<GaussWatched>& ws = gwatches[pv];
+    gauss_touched.clear();
+    for (const GaussWatched& w: ws) {
+        if (w.matrix_num == 1000) continue;
+        SLOW_DEBUG_DO(assert(w.matrix_num < gmatrices.size()));
+        GaussQData& gqd = gqueuedata[w.matrix_num];
+        if (gqd.touched || gqd.disabled
+            || !gmatrices[w.matrix_num]->is_initialized()) continue;
+        gqd.touched = true;
+        gqd.reset();
+        gmatrices[w.matrix_num]->update_cols_vals_set();
+        gauss_touched.push_back(w.matrix_num);
     }
 
     bool confl_in_gauss = false;
-    assert(gwatches.size() > pv);
-    vec<GaussWatched>& ws = gwatches[pv];
     GaussWatched* i = ws.begin();
     GaussWatched* j = i;
     const GaussWatched* end = ws.end();
@@ -252,9 +261,12 @@ PropBy PropEngine::gauss_jordan_elim(const Lit p, const uint32_t currLevel)
 
     for (; i != end; i++) *j++ = *i;
     ws.shrink(i-j);
+    for(const uint32_t g: gauss_touched) gqueuedata[g].touched = false;
     if (confl != PropBy()) return confl;
 
-    for (size_t g = 0; g < gqueuedata.size(); g++) {
+    //Same order as going through all matrices
+    std::sort(gauss_touched.begin(), gauss_touched.end());
+    for (const uint32_t g: gauss_touched) {
         if (gqueuedata[g].disabled || !gmatrices[g]->is_initialized())
             continue;
 
@@ -264,7 +276,8 @@ PropBy PropEngine::gauss_jordan_elim(const Lit p, const uint32_t currLevel)
         }
     }
 
-    for (GaussQData& gqd: gqueuedata) {
+    for (const uint32_t g: gauss_touched) {
+        GaussQData& gqd = gqueuedata[g];
         if (gqd.disabled) continue;
 
         //There was a conflict but this is not that matrix.
@@ -261,6 +261,7 @@ public:
     enum class gauss_ret {g_cont, g_nothing, g_false};
     vector<EGaussian*> gmatrices;
     vector<GaussQData> gqueuedata;
+    vector<uint32_t> gauss_touched; ///< Matrices consulted for the literal being propagated
 
 protected:
     friend class DataSync;
@@ -54,36 +54,6 @@ struct SortValAndPos {
     }
 };
 
-struct SortRedClsGlue
-{
-    explicit SortRedClsGlue(ClauseAllocator& _cl_alloc) :
-        cl_alloc(_cl_alloc)
-    {}
-    ClauseAllocator& cl_alloc;
-
-    inline bool operator () (const ClOffset xOff, const ClOffset yOff) const
-    {
-        const Clause* x = cl_alloc.ptr(xOff);
-        const Clause* y = cl_alloc.ptr(yOff);
-        return x->stats.glue < y->stats.glue;
-    }
-};
-
-struct SortRedClsAct
-{
-    explicit SortRedClsAct(ClauseAllocator& _cl_alloc) :
-        cl_alloc(_cl_alloc)
-    {}
-    ClauseAllocator& cl_alloc;
-
-    inline bool operator () (const ClOffset xOff, const ClOffset yOff) const
-    {
-        const Clause* x = cl_alloc.ptr(xOff);
-        const Clause* y = cl_alloc.ptr(yOff);
-        return x->stats.activity > y->stats.activity;
-    }
-};
-
 #if defined(STATS_NEEDED) || defined(FINAL_PREDICTOR)
 struct SortRedClsUIP1
 {
@@ -190,37 +160,13 @@ ReduceDB::~ReduceDB()
     #endif
 }
 
-void ReduceDB::sort_red_cls(ClauseClean clean_type)
+size_t ReduceDB::mem_used() const
 {
-    #ifdef VERBOSE_DEBUG
-    cout << "Before sort" << endl;
-    uint64_t i = 0;
-    for(const auto& x: solver->longRedCls[2]) {
-        const ClOffset offset = x;
-        Clause* cl = solver->cl_alloc.ptr(offset);
-        cout << i << " offset: " << offset << " cl->stats.last_touched_any: " << cl->stats.last_touched_any
-        << " act:" << std::setprecision(9) << cl->stats.activity
-        << " which_red_array:" << cl->stats.which_red_array << endl
-        << " -- cl:" << *cl << " tern:" << cl->stats.is_ternary_resolvent
-        << endl;
-    }
-    #endif
-
-    switch (clean_type) {
-        case ClauseClean::glue : {
-            std::sort(solver->longRedCls[2].begin(), solver->longRedCls[2].end(), SortRedClsGlue(solver->cl_alloc));
-            break;
-        }
-
-        case ClauseClean::activity : {
-            std::sort(solver->longRedCls[2].begin(), solver->longRedCls[2].end(), SortRedClsAct(solver->cl_alloc));
-            break;
-        }
-
-        default: {
-            assert(false && "Unknown cleaning type");
-        }
-    }
+    size_t mem = 0;
+    mem += delayed_clause_free.capacity()*sizeof(ClOffset);
+    mem += cl_stats.capacity()*sizeof(ClauseStats);
+    mem += red_keys.capacity()*sizeof(RedClKey);
+    return mem;
 }
 
 #if defined(NORMAL_CL_USE_STATS)
@@ -245,7 +191,7 @@ void ReduceDB::gather_normal_cl_use_stats()
 
 //TODO maybe we chould count binary learnt clauses as well into the
 //kept no. of clauses as other solvers do
-void ReduceDB::handle_lev2()
+void ReduceDB::handle_lev2(const double keep_mult)
 {
     solver->dump_memory_stats_to_sql();
     size_t orig_size = solver->longRedCls[2].size();
@@ -259,12 +205,11 @@ void ReduceDB::handle_lev2()
         ; keep_type < sizeof(solver->conf.ratio_keep_clauses)/sizeof(double)
         ; keep_type++
     ) {
-        const uint64_t keep_num = (double)num_to_reduce*solver->conf.ratio_keep_clauses[keep_type];
+        const uint64_t keep_num = (double)num_to_reduce*solver->conf.ratio_keep_clauses[keep_type]*keep_mult;
         if (keep_num == 0) {
             continue;
         }
-        sort_red_cls(static_cast<ClauseClean>(keep_type));
-        mark_top_N_clauses_lev2(keep_num);
+        mark_top_N_clauses_lev2(static_cast<ClauseClean>(keep_type), keep_num);
     }
     assert(delayed_clause_free.empty());
     cl_marked = 0;
@@ -282,6 +227,7 @@ void ReduceDB::handle_lev2()
     solver->check_no_removed_or_freed_cl_in_watch();
     #endif
 
+    const double time_used = cpuTime() - my_time;
     if (solver->conf.verbosity >= 2) {
         cout << "c [DBclean lev2]"
         << " confl: " << solver->sumConflicts
@@ -289,7 +235,7 @@ void ReduceDB::handle_lev2()
         << " marked: " << cl_marked
         << " ttl:" << cl_ttl
         << " locked_solver:" << cl_locked_solver
-        << solver->conf.print_times(cpuTime()-my_time)
+        << solver->conf.print_times(time_used)
         << endl;
     }
 
@@ -297,10 +243,11 @@ void ReduceDB::handle_lev2()
         solver->sqlStats->time_passed_min(
             solver
             , "dbclean-lev2"
-            , cpuTime()-my_time
+            , time_used
         );
     }
-    total_time += cpuTime()-my_time;
+    total_time += time_used;
+    lev2_time += time_used;
 
     last_reducedb_num_conflicts = solver->sumConflicts;
 }
@@ -590,6 +537,7 @@ void ReduceDB::handle_lev1()
     }
     solver->longRedCls[1].resize(j);
 
+    const double time_used = cpuTime() - my_time;
     if (solver->conf.verbosity >= 2) {
         cout << "c [DBclean lev1]"
         << " confl: " << solver->sumConflicts
@@ -597,7 +545,7 @@ void ReduceDB::handle_lev1()
         << " used recently: " << used_recently
         << " not used recently: " << non_recent_use
         << " moved w0: " << moved_w0
-        << solver->conf.print_times(cpuTime()-my_time)
+        << solver->conf.print_times(time_used)
         << endl;
     }
 
@@ -605,10 +553,11 @@ void ReduceDB::handle_lev1()
         solver->sqlStats->time_passed_min(
             solver
             , "dbclean-lev1"
-            , cpuTime()-my_time
+            , time_used
         );
     }
-    total_time += cpuTime()-my_time;
+    total_time += time_used;
+    lev1_time += time_used;
 }
 
 #ifdef FINAL_PREDICTOR
@@ -1203,46 +1152,52 @@ void ReduceDB::handle_predictors()
 }
 #endif
 
-void ReduceDB::mark_top_N_clauses_lev2(const uint64_t keep_num)
+void ReduceDB::mark_top_N_clauses_lev2(const ClauseClean clean_type, const uint64_t keep_num)
 {
     #ifdef VERBOSE_DEBUG
     cout << "Marking top N clauses " << keep_num << endl;
     #endif
 
-    size_t marked = 0;
-    for(size_t i = 0
-        ; i < solver->longRedCls[2].size() && marked < keep_num
-        ; i++
-    ) {
-        const ClOffset offset = solver->longRedCls[2][i];
-        Clause* cl = solver->cl_alloc.ptr(offset);
-        #ifdef VERBOSE_DEBUG
-        cout << "offset: " << offset << " cl->stats.last_touched_any: " << cl->stats.last_touched_any
-        << " act:" << std::setprecision(9) << cl->stats.activity
-        << " which_red_array:" << cl->stats.which_red_array << endl
-        << " -- cl:" << *cl << " tern:" << cl->stats.is_ternary_resolvent
-        << endl;
-        #endif
-
+    //Keys are read from the arena once, the selection only touches red_keys
+    red_keys.clear();
+    for(const ClOffset offset: solver->longRedCls[2]) {
+        const Clause* cl = solver->cl_alloc.ptr(offset);
         if (cl->stats.ttl > 0
-            || solver->clause_locked(*cl, offset)
+            || cl->stats.marked_clause
             || cl->stats.which_red_array != 2
+            || solver->clause_locked(*cl, offset)
         ) {
             //no need to mark, skip
-            #ifdef VERBOSE_DEBUG
-            cout << "Not marking Skipping "<< endl;
-            #endif
             continue;
         }
 
-        if (!cl->stats.marked_clause) {
-            marked++;
-            cl->stats.marked_clause = true;
-            #ifdef VERBOSE_DEBUG
-            cout << "Not marking Skipping "<< endl;
-            #endif
+        switch (clean_type) {
+            case ClauseClean::glue:
+                red_keys.push_back(RedClKey{(float)cl->stats.glue, offset});
+                break;
+            case ClauseClean::activity:
+                red_keys.push_back(RedClKey{-cl->stats.activity, offset});
+                break;
+            default:
+                assert(false && "Unknown cleaning type");
         }
     }
+
+    //Lower key is better
+    const auto cmp = [](const RedClKey& a, const RedClKey& b) { return a.key < b.key; };
+    if (keep_num < red_keys.size()) {
+        std::nth_element(red_keys.begin(), red_keys.begin()+keep_num, red_keys.end(), cmp);
+        red_keys.resize(keep_num);
+    }
+    for(const auto& k: red_keys) {
+        Clause* cl = solver->cl_alloc.ptr(k.offset);
+        #ifdef VERBOSE_DEBUG
+        cout << "Marking offset: " << k.offset
+        << " act:" << std::setprecision(9) << cl->stats.activity
+        << " -- cl:" << *cl << endl;
+        #endif
+        cl->stats.marked_clause = true;
+    }
 }
 
 bool ReduceDB::cl_needs_removal(const Clause* cl, const ClOffset offset) const
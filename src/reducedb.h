@@ -24,6 +24,9 @@ THE SOFTWARE.
 #define __REDUCEDB_H__
 
 #include "clauseallocator.h"
+#ifdef CMS_TESTING_ENABLED
+#include "gtest/gtest_prod.h"
+#endif
 #ifdef FINAL_PREDICTOR
 #include "cl_predictors_abs.h"
 #endif
@@ -46,8 +49,12 @@ public:
     double get_total_time() const {
         return total_time;
     }
+    double get_lev1_time() const { return lev1_time; }
+    double get_lev2_time() const { return lev2_time; }
     void handle_lev1();
-    void handle_lev2();
+    //keep_mult < 1 keeps fewer clauses than usual, to save memory
+    void handle_lev2(const double keep_mult = 1.0);
+    size_t mem_used() const;
     void gather_normal_cl_use_stats();
     #ifdef FINAL_PREDICTOR
     void handle_predictors();
@@ -83,6 +90,8 @@ private:
     Solver* solver;
     vector<ClOffset> delayed_clause_free;
     double total_time = 0.0;
+    double lev1_time = 0.0;
+    double lev2_time = 0.0;
 
     unsigned cl_marked;
     unsigned cl_ttl;
@@ -96,8 +105,15 @@ private:
     bool cl_needs_removal(const Clause* cl, const ClOffset offset) const;
     void remove_cl_from_lev2();
 
-    void sort_red_cls(ClauseClean clean_type);
-    void mark_top_N_clauses_lev2(const uint64_t keep_num);
+    struct RedClKey {
+        float key;
+        ClOffset offset;
+    };
+    vector<RedClKey> red_keys;
+    void mark_top_N_clauses_lev2(const ClauseClean clean_type, const uint64_t keep_num);
+    #ifdef CMS_TESTING_ENABLED
+    FRIEND_TEST(SolverTest, lev2_marks_same_as_sort);
+    #endif
 
     #ifdef FINAL_PREDICTOR
     ClPredictorsAbst* predictors = nullptr;
@@ -100,7 +100,8 @@ void SatZillaFeatures::print_stats() const
     red_cl_distrib.print("red_cl_distrib.");
 
     cout << "num_gates_found_last " << num_gates_found_last << ", ";
-    cout << "num_xors_found_last " << num_xors_found_last;
+    cout << "num_xors_found_last " << num_xors_found_last << ", ";
+    cout << "num_bnns " << num_bnns;
     cout << endl;
 }
 
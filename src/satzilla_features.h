@@ -120,6 +120,7 @@ struct SatZillaFeatures
     //High-level satzilla_features
     uint64_t num_gates_found_last = 0;
     uint64_t num_xors_found_last = 0;
+    uint64_t num_bnns = 0;
 };
 
 }
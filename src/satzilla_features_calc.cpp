@@ -31,81 +31,18 @@ THE SOFTWARE.
 using std::vector;
 using namespace CMSat;
 
-template<class Function, class Function2>
-void SatZillaFeaturesCalc::for_one_clause(
-    const Watched& cl
-    , const Lit lit
-    ,  Function func_each_cl
-    ,  Function2 func_each_lit
-) const {
-    unsigned neg_vars = 0;
-    unsigned pos_vars = 0;
-    unsigned size = 0;
-
-    switch (cl.getType()) {
-        case WatchType::watch_binary_t: {
-            if (cl.red()) {
-                //only irred cls
-                break;
-            }
-            if (lit > cl.lit2()) {
-                //only count once
-                break;
-            }
-
-            pos_vars += !lit.sign();
-            pos_vars += !cl.lit2().sign();
-            size = 2;
-            neg_vars = size - pos_vars;
-            func_each_cl(size, pos_vars, neg_vars);
-            func_each_lit(lit, size, pos_vars, neg_vars);
-            func_each_lit(cl.lit2(), size, pos_vars, neg_vars);
-            break;
-        }
-        case WatchType::watch_bnn_t:
-            release_assert(false && "Not implemented");
-            break;
-
-        case WatchType::watch_clause_t: {
-            const Clause& clause = *solver->cl_alloc.ptr(cl.get_offset());
-            if (clause.red()) {
-                //only irred cls
-                break;
-            }
-            if (clause[0] < clause[1]) {
-                //only count once
-                break;
-            }
-
-            for (const Lit cl_lit : clause) {
-                pos_vars += !cl_lit.sign();
-            }
-            size = clause.size();
-            neg_vars = size - pos_vars;
-            func_each_cl(size, pos_vars, neg_vars);
-            for (const Lit cl_lit : clause) {
-                func_each_lit(cl_lit, size, pos_vars, neg_vars);
-            }
-            break;
-        }
-
-        case WatchType::watch_idx_t: {
-             // This should never be here
-            assert(false);
-            exit(-1);
-            break;
-        }
-    }
-}
-
-template<class Function, class Function2>
-void SatZillaFeaturesCalc::for_all_clauses(Function func_each_cl, Function2 func_each_lit) const
+void SatZillaFeaturesCalc::add_clause(const Lit* lits, const uint32_t size, const uint32_t weight)
 {
-    for (size_t i = 0; i < solver->nVars() * 2; i++) {
-        Lit lit = Lit::toLit(i);
-        for (const Watched & w : solver->watches[lit]) {
-            for_one_clause(w, lit, func_each_cl, func_each_lit);
-        }
+    uint32_t pos_vars = 0;
+    for(uint32_t i = 0; i < size; i++) pos_vars += !lits[i].sign();
+    cls_hist[std::make_pair(size, pos_vars)] += weight;
+
+    for(uint32_t i = 0; i < size; i++) {
+        VARIABLE& v = myVars[lits[i].var()];
+        v.occurs = true;
+        if (pos_vars <= 1) v.horn += weight;
+        if (!lits[i].sign()) v.numPos += weight;
+        v.size += weight;
     }
 }
 
@@ -113,47 +50,63 @@ void SatZillaFeaturesCalc::fill_vars_cls()
 {
     satzilla_feat.numVars = solver->get_num_free_vars();
     satzilla_feat.numClauses = solver->longIrredCls.size() + solver->binTri.irredBins;
+    myVars.clear();
     myVars.resize(solver->nVars());
-
-    auto func_each_cl = [&](unsigned /*size*/, unsigned pos_vars, unsigned /*neg_vars*/) -> bool {
-        if (pos_vars <= 1 ) {
-            satzilla_feat.horn += 1;
-            return true;
-        }
-        return false;
-    };
-    auto func_each_lit = [&](Lit lit, unsigned /*size*/, unsigned pos_vars, unsigned /*neg_vars*/) -> void {
-        if (pos_vars <= 1 ) {
-            myVars[lit.var()].horn++;
+    cls_hist.clear();
+
+    //Too large, only look at every sample_every-th clause
+    const uint64_t tot_lits = solver->litStats.irredLits + solver->binTri.irredBins*2;
+    const uint64_t max_lits = solver->conf.satzilla_sample_litsM*1000ULL*1000ULL;
+    sample_every = 1;
+    if (max_lits > 0 && tot_lits > max_lits) sample_every = (tot_lits+max_lits-1)/max_lits;
+
+    //The variables of the clauses that are not sampled must still be counted,
+    //or numVars would shrink with the sample
+    uint64_t at = 0;
+    Lit lits[2];
+    for (size_t i = 0; i < solver->nVars() * 2; i++) {
+        const Lit lit = Lit::toLit(i);
+        for (const Watched& w : solver->watches[lit]) {
+            if (!w.isBin() || w.red() || lit > w.lit2()) continue;
+            if (at++ % sample_every != 0) {
+                myVars[lit.var()].occurs = true;
+                myVars[w.lit2().var()].occurs = true;
+                continue;
+            }
+            lits[0] = lit;
+            lits[1] = w.lit2();
+            add_clause(lits, 2, sample_every);
         }
-
-        if (!lit.sign()) {
-            myVars[lit.var()].numPos++;
+    }
+    for(const ClOffset off: solver->longIrredCls) {
+        const Clause& cl = *solver->cl_alloc.ptr(off);
+        if (at++ % sample_every != 0) {
+            for(const Lit l: cl) myVars[l.var()].occurs = true;
+            continue;
         }
-        myVars[lit.var()].size++;
-    };
-    for_all_clauses(func_each_cl, func_each_lit);
+        add_clause(cl.begin(), cl.size(), sample_every);
+    }
 }
 
 void SatZillaFeaturesCalc::calculate_clause_stats()
 {
-    auto empty_func = [](const Lit, unsigned /*size*/, unsigned /*pos_vars*/, unsigned /*neg_vars*/) -> void {};
-    auto func_each_cl = [&](unsigned size, unsigned pos_vars, unsigned /*neg_vars*/) -> void {
-        if (size == 0 ) {
-            return;
-        }
-
-        double _size = (double)size / (double)satzilla_feat.numVars;
+    for(const auto& h: cls_hist) {
+        const double size = h.first.first;
+        const double pos_vars = h.first.second;
+        const double cnt = h.second;
+        if (size == 0) continue;
+        if (pos_vars <= 1) satzilla_feat.horn += cnt;
+
+        double _size = size / (double)satzilla_feat.numVars;
         satzilla_feat.vcg_cls_min = std::min(satzilla_feat.vcg_cls_min, _size);
         satzilla_feat.vcg_cls_max = std::max(satzilla_feat.vcg_cls_max, _size);
-        satzilla_feat.vcg_cls_mean += _size;
+        satzilla_feat.vcg_cls_mean += cnt*_size;
 
-        double _pnr = 0.5 + ((2.0 * (double)pos_vars - (double)size) / (2.0 * (double)size));
+        double _pnr = 0.5 + ((2.0 * pos_vars - size) / (2.0 * size));
         satzilla_feat.pnr_cls_min = std::min(satzilla_feat.pnr_cls_min, _pnr);
         satzilla_feat.pnr_cls_max = std::max(satzilla_feat.pnr_cls_max, _pnr);
-        satzilla_feat.pnr_cls_mean += _pnr;
-    };
-    for_all_clauses(func_each_cl, empty_func);
+        satzilla_feat.pnr_cls_mean += cnt*_pnr;
+    }
 
     satzilla_feat.vcg_cls_mean /= (double)satzilla_feat.numClauses;
     satzilla_feat.pnr_cls_mean /= (double)satzilla_feat.numClauses;
@@ -162,6 +115,31 @@ void SatZillaFeaturesCalc::calculate_clause_stats()
 
     satzilla_feat.vcg_cls_spread = satzilla_feat.vcg_cls_max - satzilla_feat.vcg_cls_min;
     satzilla_feat.pnr_cls_spread = satzilla_feat.pnr_cls_max - satzilla_feat.pnr_cls_min;
+
+    //Standard deviations
+    for(const auto& h: cls_hist) {
+        const double size = h.first.first;
+        const double pos_vars = h.first.second;
+        const double cnt = h.second;
+        if (size == 0) continue;
+
+        double _size = size / (double)satzilla_feat.numVars;
+        satzilla_feat.vcg_cls_std += cnt * (satzilla_feat.vcg_cls_mean - _size) * (satzilla_feat.vcg_cls_mean - _size);
+
+        double _pnr = 0.5 + ((2.0 * pos_vars - size) / (2.0 * size));
+        satzilla_feat.pnr_cls_std += cnt * (satzilla_feat.pnr_cls_mean - _pnr) * (satzilla_feat.pnr_cls_mean - _pnr);
+    }
+
+    if ( satzilla_feat.vcg_cls_std > satzilla_feat.eps && satzilla_feat.vcg_cls_mean > satzilla_feat.eps ) {
+        satzilla_feat.vcg_cls_std = std::sqrt(satzilla_feat.vcg_cls_std / (double)satzilla_feat.numClauses) / satzilla_feat.vcg_cls_mean;
+    } else {
+        satzilla_feat.vcg_cls_std = 0;
+    }
+    if ( satzilla_feat.pnr_cls_std > satzilla_feat.eps && satzilla_feat.pnr_cls_mean > satzilla_feat.eps ) {
+        satzilla_feat.pnr_cls_std = std::sqrt(satzilla_feat.pnr_cls_std / (double)satzilla_feat.numClauses) / satzilla_feat.pnr_cls_mean;
+    } else {
+        satzilla_feat.pnr_cls_std = 0;
+    }
 }
 
 void SatZillaFeaturesCalc::calculate_variable_stats()
@@ -206,34 +184,6 @@ void SatZillaFeaturesCalc::calculate_variable_stats()
     satzilla_feat.horn_spread = satzilla_feat.horn_max - satzilla_feat.horn_min;
 }
 
-void SatZillaFeaturesCalc::calculate_extra_clause_stats()
-{
-    auto empty_func = [](const Lit, unsigned /*size*/, unsigned /*pos_vars*/, unsigned /*neg_vars*/) -> void {};
-    auto each_clause = [&](unsigned size, unsigned pos_vars, unsigned /*neg_vars*/) -> void {
-        if ( size == 0 ) {
-            return;
-        }
-
-        double _size = (double)size / (double)satzilla_feat.numVars;
-        satzilla_feat.vcg_cls_std += (satzilla_feat.vcg_cls_mean - _size) * (satzilla_feat.vcg_cls_mean - _size);
-
-        double _pnr = 0.5 + ((2.0 * (double)pos_vars - (double)size) / (2.0 * (double)size));
-        satzilla_feat.pnr_cls_std += (satzilla_feat.pnr_cls_mean - _pnr) * (satzilla_feat.pnr_cls_mean - _pnr);
-    };
-    for_all_clauses(each_clause, empty_func);
-
-    if ( satzilla_feat.vcg_cls_std > satzilla_feat.eps && satzilla_feat.vcg_cls_mean > satzilla_feat.eps ) {
-        satzilla_feat.vcg_cls_std = std::sqrt(satzilla_feat.vcg_cls_std / (double)satzilla_feat.numClauses) / satzilla_feat.vcg_cls_mean;
-    } else {
-        satzilla_feat.vcg_cls_std = 0;
-    }
-    if ( satzilla_feat.pnr_cls_std > satzilla_feat.eps && satzilla_feat.pnr_cls_mean > satzilla_feat.eps ) {
-        satzilla_feat.pnr_cls_std = std::sqrt(satzilla_feat.pnr_cls_std / (double)satzilla_feat.numClauses) / satzilla_feat.pnr_cls_mean;
-    } else {
-        satzilla_feat.pnr_cls_std = 0;
-    }
-}
-
 void SatZillaFeaturesCalc::calculate_extra_var_stats()
 {
     if (satzilla_feat.numVars == 0)
@@ -293,32 +243,38 @@ void SatZillaFeaturesCalc::calculate_cl_distributions(
     double activity_mean = 0;
     double activity_var = 0;
 
+    //Too many, only look at a sample of them. 0 means never sample
+    const uint64_t max_cls = solver->conf.satzilla_sample_litsM*100ULL*1000ULL;
+    const size_t step = max_cls == 0 ? 1 : std::max<size_t>(1, (clauses.size()+max_cls-1)/max_cls);
+    size_t num = 0;
+
     //Calculate means
     double cla_inc = solver->get_cla_inc();
-    for(ClOffset off: clauses)
+    for(size_t i = 0; i < clauses.size(); i += step)
     {
-        const Clause& cl = *solver->cl_alloc.ptr(off);
+        const Clause& cl = *solver->cl_alloc.ptr(clauses[i]);
         size_mean += cl.size();
         glue_mean += cl.stats.glue;
         if (cl.red()) {
             activity_mean += (double)cl.stats.activity/cla_inc;
         }
+        num++;
     }
-    size_mean /= clauses.size();
-    glue_mean /= clauses.size();
-    activity_mean /= clauses.size();
+    size_mean /= num;
+    glue_mean /= num;
+    activity_mean /= num;
 
     //Calculate variances
-    for(ClOffset off: clauses)
+    for(size_t i = 0; i < clauses.size(); i += step)
     {
-        const Clause& cl = *solver->cl_alloc.ptr(off);
+        const Clause& cl = *solver->cl_alloc.ptr(clauses[i]);
         size_var += std::pow(size_mean-cl.size(), 2);
         glue_var += std::pow(glue_mean-cl.stats.glue, 2);
         activity_var += std::pow(activity_mean-(double)cl.stats.activity/cla_inc, 2);
     }
-    size_var /= clauses.size();
-    glue_var /= clauses.size();
-    activity_var /= clauses.size();
+    size_var /= num;
+    glue_var /= num;
+    activity_var /= num;
 
     //Assign calculated values
     distrib_data.glue_distr_mean = glue_mean;
@@ -357,14 +313,27 @@ void SatZillaFeaturesCalc::normalise_values()
         satzilla_feat.pnr_cls_max = -1;
 }
 
-SatZillaFeatures SatZillaFeaturesCalc::extract()
+SatZillaFeaturesCalc::Signature SatZillaFeaturesCalc::get_signature() const
+{
+    Signature sig;
+    sig.num_simplify = solver->get_solve_stats().num_simplify;
+    sig.nvars = solver->nVars();
+    sig.free_vars = solver->get_num_free_vars();
+    sig.long_irred = solver->longIrredCls.size();
+    sig.irred_bins = solver->binTri.irredBins;
+    sig.irred_lits = solver->litStats.irredLits;
+    return sig;
+}
+
+void SatZillaFeaturesCalc::recalc_irred()
 {
     double start_time = cpuTime();
+    satzilla_feat = SatZillaFeatures();
     fill_vars_cls();
 
     satzilla_feat.numVars = 0;
     for ( int vv = 0; vv < (int)myVars.size(); vv++ ) {
-        if ( myVars[vv].size > 0 ) {
+        if ( myVars[vv].occurs ) {
             satzilla_feat.numVars++;
         }
     }
@@ -375,22 +344,24 @@ SatZillaFeatures SatZillaFeaturesCalc::extract()
     if (satzilla_feat.numClauses > 0 && satzilla_feat.numVars > 0) {
         calculate_clause_stats();
         calculate_variable_stats();
-
-        calculate_extra_clause_stats();
         calculate_extra_var_stats();
 
-        if (!solver->longRedCls[0].empty()) {
-            calculate_cl_distributions(solver->longRedCls[0], satzilla_feat.red_cl_distrib);
-        }
         if (!solver->longIrredCls.empty()) {
             calculate_cl_distributions(solver->longIrredCls, satzilla_feat.irred_cl_distrib);
         }
     }
     normalise_values();
+    myVars.clear();
+    myVars.shrink_to_fit();
+    irred_sig = get_signature();
+    irred_valid = true;
+    num_recalc++;
 
     double time_used = cpuTime() - start_time;
     if (solver->conf.verbosity) {
-        cout << "c [szfeat] satzilla features extracted "
+        cout << "c [szfeat] satzilla features extracted"
+        << " sampled 1/" << sample_every
+        << " recalc: " << num_recalc << " reused: " << num_reused
         << solver->conf.print_times(time_used)
         << endl;
     }
@@ -402,6 +373,17 @@ SatZillaFeatures SatZillaFeaturesCalc::extract()
             , time_used
         );
     }
+}
 
-    return satzilla_feat;
+SatZillaFeatures SatZillaFeaturesCalc::extract()
+{
+    if (!irred_valid || !(get_signature() == irred_sig)) recalc_irred();
+    else num_reused++;
+
+    //Redundant clauses change all the time, but there are few in tier 0
+    SatZillaFeatures ret = satzilla_feat;
+    if (ret.numClauses > 0 && ret.numVars > 0 && !solver->longRedCls[0].empty()) {
+        calculate_cl_distributions(solver->longRedCls[0], ret.red_cl_distrib);
+    }
+    return ret;
 }
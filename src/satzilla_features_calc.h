@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <vector>
 #include <limits>
 #include <utility>
+#include <map>
 #include "satzilla_features.h"
 #include "cloffset.h"
 #include "watched.h"
@@ -37,6 +38,10 @@ namespace CMSat {
 
 class Solver;
 
+// Keeps the features of the irredundant clause database between calls, and
+// only re-walks it once it changed. On large instances only a sample of the
+// clauses is counted and the counts are scaled up. The variables are counted
+// over all clauses.
 struct SatZillaFeaturesCalc {
 public:
     SatZillaFeaturesCalc(const Solver* _solver) :
@@ -45,36 +50,51 @@ public:
     SatZillaFeatures extract();
 
 private:
+    struct Signature {
+        uint64_t num_simplify = 0;
+        uint64_t nvars = 0;
+        uint64_t free_vars = 0;
+        uint64_t long_irred = 0;
+        uint64_t irred_bins = 0;
+        uint64_t irred_lits = 0;
+        bool operator==(const Signature& o) const {
+            return num_simplify == o.num_simplify && nvars == o.nvars
+                && free_vars == o.free_vars && long_irred == o.long_irred
+                && irred_bins == o.irred_bins && irred_lits == o.irred_lits;
+        }
+    };
+    Signature get_signature() const;
+    void recalc_irred();
+
     void fill_vars_cls();
+    void add_clause(const Lit* lits, const uint32_t size, const uint32_t weight);
     void calculate_clause_stats();
     void calculate_variable_stats();
     void calculate_extra_var_stats();
-    void calculate_extra_clause_stats();
     void normalise_values();
     void calculate_cl_distributions(
         const vector<ClOffset>& clauses
         , struct SatZillaFeatures::Distrib& distrib_data
     );
 
-
     const Solver* solver;
-    template<class Function, class Function2>
-    void for_one_clause(
-        const Watched& cl
-        , const Lit lit
-        ,  Function func
-        ,  Function2 func_each_lit
-    ) const;
-    template<class Function, class Function2>
-    void for_all_clauses(Function for_each_clause,  Function2 func_each_lit) const;
     struct VARIABLE {
-        int numPos = 0;
-        int size = 0;
-        int horn = 0;
+        uint64_t numPos = 0;
+        uint64_t size = 0;
+        uint64_t horn = 0;
+        bool occurs = false; ///< In any clause, sampled or not
     };
 
     vector<VARIABLE> myVars;
-    SatZillaFeatures satzilla_feat;
+    //(size, number of positive lits) -> number of clauses
+    std::map<pair<uint32_t, uint32_t>, uint64_t> cls_hist;
+    uint32_t sample_every = 1;
+
+    bool irred_valid = false;
+    Signature irred_sig;
+    SatZillaFeatures satzilla_feat; ///< Irredundant part, valid while irred_sig matches
+    uint64_t num_recalc = 0;
+    uint64_t num_reused = 0;
 };
 
 } //end namespace
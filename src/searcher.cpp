@@ -55,6 +55,7 @@ THE SOFTWARE.
 #include "str_impl_w_impl.h"
 #include "subsumeimplicit.h"
 #include "sls.h"
+#include "membudget.h"
 #ifdef USE_VALGRIND
 #include "valgrind/valgrind.h"
 #include "valgrind/memcheck.h"
@@ -135,16 +136,16 @@ void Searcher::save_on_var_memory()
 }
 
 void Searcher::updateVars(
-    [[maybe_unused]] const vector<uint32_t>& outer_to_inter
+    const vector<uint32_t>& outer_to_inter
     , const vector<uint32_t>& inter_to_outer
 ) {
     updateArray(var_act_vsids, inter_to_outer);
     updateArray(vmtf_btab, inter_to_outer);
     updateArray(vmtf_links, inter_to_outer);
 
-    auto upd = [&](uint32_t v) {
+    auto upd = [&](uint32_t& v) {
         if (v != numeric_limits<uint32_t>::max())
-            v = inter_to_outer[v];
+            v = outer_to_inter[v];
     };
 
     for(auto& l: vmtf_links) {
@@ -837,12 +838,20 @@ void Searcher::analyze_conflict(
 
 #endif
     minimize_learnt_clause<inprocess>();
+
+    //Shrinking keeps one literal on each level, so the glue does not change
+    glue = numeric_limits<uint32_t>::max();
+    if (conf.do_shrink && learnt_clause.size() > 2) {
+        glue = calc_glue(learnt_clause);
+        if (glue <= conf.max_glue_shrink && learnt_clause.size() > glue) {
+            shrink_learnt_clause();
+        }
+    }
     stats.litsRedFinal += learnt_clause.size();
 
     //further minimisation 1 -- short, small glue clauses
-    glue = numeric_limits<uint32_t>::max();
     if (learnt_clause.size() <= conf.max_size_more_minim) {
-        glue = calc_glue(learnt_clause);
+        if (glue == numeric_limits<uint32_t>::max()) glue = calc_glue(learnt_clause);
         if (glue <= conf.max_glue_more_minim) {
             minimize_using_bins();
         }
@@ -906,6 +915,149 @@ void Searcher::analyze_conflict(
     sumConflictClauseLits += learnt_clause.size();
 }
 
+// All-UIP shrinking: the literals of a level are replaced by the first UIP of
+// that level (the block-UIP) when it can be reached by resolving only on
+// literals of that level, and all lower-level literals met are in the clause.
+// The trail is walked once from the top for all levels, since with chrono BT
+// the literals of a level are not contiguous on it.
+void Searcher::shrink_learnt_clause()
+{
+    assert(toClear.empty());
+    assert(shrink_chain.empty());
+    stats.shrinkAttempt++;
+    const size_t origSize = learnt_clause.size();
+    for(const Lit l: learnt_clause) {
+        seen[l.var()] = 1;
+        toClear.push_back(l);
+    }
+
+    std::sort(learnt_clause.begin()+1, learnt_clause.end(),
+        [&](const Lit a, const Lit b) {
+            return varData[a.var()].level > varData[b.var()].level;
+    });
+    const uint32_t max_lev = varData[learnt_clause[1].var()].level;
+    if (shrink_open.size() <= max_lev) {
+        shrink_open.resize(max_lev+1, 0);
+        shrink_uip.resize(max_lev+1, lit_Undef);
+    }
+
+    uint32_t active = 0;
+    for(size_t i = 1; i < learnt_clause.size(); i++) {
+        const uint32_t lev = varData[learnt_clause[i].var()].level;
+        if (++shrink_open[lev] == 2) active++;
+    }
+    for(size_t i = 1; i < learnt_clause.size(); i++) {
+        const uint32_t lev = varData[learnt_clause[i].var()].level;
+        if (shrink_open[lev] == 1) shrink_open[lev] = 0;
+    }
+    stats.shrinkBlocks += active;
+
+    for(int64_t i = (int64_t)trail.size()-1; i >= 0 && active > 0; i--) {
+        stats.shrinkCost++;
+        const Lit p = trail[i].lit;
+        const uint32_t lev = trail[i].lev;
+        if (lev > max_lev || shrink_open[lev] == 0 || !seen[p.var()]) continue;
+
+        if (shrink_open[lev] == 1) {
+            shrink_uip[lev] = p;
+            shrink_open[lev] = 0;
+            active--;
+            continue;
+        }
+
+        const PropBy reason = varData[p.var()].reason;
+        assert(!reason.isnullptr());
+        int32_t ID = 0;
+        size_t size;
+        Lit* lits = nullptr;
+        switch (reason.getType()) {
+            case clause_t: {
+                Clause* cl = cl_alloc.ptr(reason.get_offset());
+                lits = cl->begin();
+                size = cl->size();
+                ID = cl->stats.ID;
+                break;
+            }
+
+            case xor_t: {
+                auto cl = get_xor_reason(reason, ID);
+                lits = cl->data();
+                size = cl->size();
+                break;
+            }
+
+            case bnn_t: {
+                vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()], p);
+                lits = cl->data();
+                size = cl->size();
+                break;
+            }
+
+            case binary_t:
+                size = 2;
+                ID = reason.getID();
+                break;
+
+            case null_clause_t:
+            default: release_assert(false);
+        }
+
+        bool block_ok = true;
+        for(size_t k = 1; k < size; k++) {
+            const Lit q = (reason.getType() == binary_t) ? reason.lit2() : lits[k];
+            const uint32_t qlev = varData[q.var()].level;
+            if (qlev == 0) continue;
+            if (qlev == lev) {
+                if (!seen[q.var()]) {
+                    seen[q.var()] = 2;
+                    toClear.push_back(q);
+                    shrink_open[lev]++;
+                }
+            } else if (seen[q.var()] != 1) {
+                block_ok = false;
+                break;
+            }
+        }
+        if (!block_ok) {
+            shrink_open[lev] = 0;
+            active--;
+            continue;
+        }
+        shrink_open[lev]--;
+        shrink_chain.push_back(std::make_pair(lev, ID));
+    }
+    assert(active == 0);
+
+    size_t j = 1;
+    for(size_t i = 1; i < learnt_clause.size(); i++) {
+        const uint32_t lev = varData[learnt_clause[i].var()].level;
+        if (shrink_uip[lev] == lit_Undef) {
+            learnt_clause[j++] = learnt_clause[i];
+        } else if (i+1 == learnt_clause.size()
+            || varData[learnt_clause[i+1].var()].level != lev
+        ) {
+            //last literal of the block
+            learnt_clause[j++] = ~shrink_uip[lev];
+        }
+    }
+    learnt_clause.resize(j);
+
+    for(const auto& c: shrink_chain) {
+        if (shrink_uip[c.first] != lit_Undef) chain.push_back(c.second);
+    }
+    shrink_chain.clear();
+    for(size_t i = 1; i < learnt_clause.size(); i++) {
+        const uint32_t lev = varData[learnt_clause[i].var()].level;
+        if (shrink_uip[lev] != lit_Undef) stats.shrinkBlocksOk++;
+        shrink_uip[lev] = lit_Undef;
+    }
+    for(const Lit l: toClear) seen[l.var()] = 0;
+    toClear.clear();
+
+    stats.shrinkSuccess += (origSize != learnt_clause.size());
+    stats.shrinkLitRem += origSize - learnt_clause.size();
+}
+
 bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
 {
     #ifdef DEBUG_LITREDUNDANT
@@ -1090,9 +1242,9 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                     }
 
                     case bnn_t : {
-                        vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()], lit_Undef);
+                        vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()], trail[i].lit);
                         for(const Lit lit: *cl) {
-                            if (varData[lit.var()].level > 0)seen[lit.var()] = 1;
+                            if (varData[lit.var()].level > 0) seen[lit.var()] = 1;
                         }
                         break;
                     }
@@ -1300,11 +1452,13 @@ lbool Searcher::search()
     }
     max_confl_this_restart -= (int64_t)params.confl_this_rst;
 
-    cancelUntil(0);
-    confl = propagate<false>();
-    if (!confl.isnullptr() || !solver->datasync->syncData()) {
+    cancelUntil(restart_level());
+    if (decisionLevel() > 0 && !propagate<false>().isnullptr()) {
+        //Conflict under the kept assumptions, do a full restart instead
+        cancelUntil(0);
+    }
+    if (decisionLevel() == 0 && !back_to_level0()) {
         assert(!frat->enabled() || unsat_cl_ID != 0);
-        ok = false;
         search_ret = l_False;
         goto end;
     }
@@ -1320,6 +1474,51 @@ lbool Searcher::search()
     return search_ret;
 }
 
+// Re-deciding and re-propagating thousands of assumptions after every restart
+// can dominate the run time of incremental use, so on a restart we keep the
+// decision levels that only hold assumptions. Anything that needs level 0 --
+// syncing, cleaning, inprocessing, a branching strategy change -- forces a
+// full restart instead, and solve() always returns at level 0. The levels are
+// not kept between solve() calls: in between, the caller may add clauses and
+// variables, change the assumptions or simplify, all of which need level 0.
+uint32_t Searcher::restart_level()
+{
+    if (!conf.keep_assump_levels_on_restart
+        || assumptions.empty()
+        || fast_backw.fast_backw_on
+        || solver->datasync->sync_due()
+        || level0_work_due()
+    ) {
+        return 0;
+    }
+    return std::min<uint32_t>(decisionLevel(), assumptions.size());
+}
+
+// Must mirror the conditions of the *_if_needed() calls in solve()
+bool Searcher::level0_work_due() const
+{
+    if (clean_clauses_due() || sumConflicts >= branch_strategy_change) return true;
+    if (conf.doSLS && sumConflicts > next_sls) return true;
+    if (conf.never_stop_search) return false;
+
+    return (conf.do_distill_clauses && sumConflicts > next_cls_distill)
+        || (conf.do_distill_clauses && sumConflicts > next_sub_str_with_bin)
+        || (conf.do_full_probe && sumConflicts > next_full_probe)
+        || (conf.do_distill_bin_clauses && sumConflicts > next_bins_distill)
+        || (conf.doStrSubImplicit && sumConflicts > next_str_impl_with_impl)
+        || (conf.doIntreeProbe && conf.doFindAndReplaceEqLits && sumConflicts > next_intree);
+}
+
+bool Searcher::back_to_level0()
+{
+    cancelUntil(0);
+    if (!propagate<false>().isnullptr() || !solver->datasync->syncData()) {
+        ok = false;
+        return false;
+    }
+    return true;
+}
+
 void Searcher::dump_search_sql(const double my_time)
 {
     if (solver->sqlStats) {
@@ -1775,7 +1974,7 @@ bool Searcher::handle_conflict(PropBy confl)
         , glue_before_minim         //return glue before minimization here
         , size_before_minim         //return glue before minimization here
     );
-    solver->datasync->signal_new_long_clause(learnt_clause);
+    solver->datasync->signal_new_long_clause(learnt_clause, glue);
 
     uint32_t connects_num_communities = 0;
     STATS_DO(connects_num_communities = calc_connects_num_communities(learnt_clause));
@@ -2116,6 +2315,7 @@ void Searcher::reduce_db_if_needed()
         }
     }
     #endif
+    solver->mem_budget->check_during_search();
 }
 
 bool Searcher::clean_clauses_if_needed()
@@ -2125,11 +2325,8 @@ bool Searcher::clean_clauses_if_needed()
     assert(qhead == trail.size());
     #endif
 
-    const size_t newZeroDepthAss = trail.size() - lastCleanZeroDepthAssigns;
-    if (newZeroDepthAss > 0
-        && simpDB_props < 0
-        && newZeroDepthAss > ((double)nVars()*0.05)
-    ) {
+    if (clean_clauses_due()) {
+        const size_t newZeroDepthAss = trail.size() - lastCleanZeroDepthAssigns;
         if (conf.verbosity >= 2) {
             cout << "c newZeroDepthAss : " << newZeroDepthAss
             << " -- "
@@ -2149,6 +2346,15 @@ bool Searcher::clean_clauses_if_needed()
     return okay();
 }
 
+bool Searcher::clean_clauses_due() const
+{
+    const size_t zero_depth = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    const size_t newZeroDepthAss = zero_depth - lastCleanZeroDepthAssigns;
+    return newZeroDepthAss > 0
+        && simpDB_props < 0
+        && newZeroDepthAss > ((double)nVars()*0.05);
+}
+
 void Searcher::rebuildOrderHeap() {
     verb_print(1, "[branch] rebuilding order heap for all branchings. Current branching: " <<
         branch_type_to_string(branch_strategy));
@@ -2515,20 +2721,28 @@ lbool Searcher::solve(const uint64_t _max_confls) {
 
     SLOW_DEBUG_DO(assert(fast_backw.fast_backw_on || solver->check_order_heap_sanity()));
     while(stats.conflicts < max_confl_per_search_solve_call && status == l_Undef) {
-        if (!conf.never_stop_search &&
-                (distill_clauses_if_needed() == l_False
-                || !full_probe_if_needed()
-                || !distill_bins_if_needed()
-                || !sub_str_with_bin_if_needed()
-                || !str_impl_with_impl_if_needed()
-                || !intree_if_needed())
-          ) {
+        if (decisionLevel() > 0 && level0_work_due() && !back_to_level0()) {
             assert(!frat->enabled() || unsat_cl_ID != 0);
             status = l_False;
             goto end;
         }
-        SLOW_DEBUG_DO(assert(solver->check_order_heap_sanity()));
-        sls_if_needed();
+        //With the assumption levels kept, nothing below is due
+        if (decisionLevel() == 0) {
+            if (!conf.never_stop_search &&
+                    (distill_clauses_if_needed() == l_False
+                    || !full_probe_if_needed()
+                    || !distill_bins_if_needed()
+                    || !sub_str_with_bin_if_needed()
+                    || !str_impl_with_impl_if_needed()
+                    || !intree_if_needed())
+              ) {
+                assert(!frat->enabled() || unsat_cl_ID != 0);
+                status = l_False;
+                goto end;
+            }
+            SLOW_DEBUG_DO(assert(solver->check_order_heap_sanity()));
+            sls_if_needed();
+        }
 
         assert(watches.get_smudged_list().empty());
         params.clear();
@@ -2546,6 +2760,11 @@ lbool Searcher::solve(const uint64_t _max_confls) {
     }
 
     end:
+    //Out of budget or aborted while the assumption levels are kept
+    if (status == l_Undef && decisionLevel() > 0 && !back_to_level0()) {
+        assert(!frat->enabled() || unsat_cl_ID != 0);
+        status = l_False;
+    }
     finish_up_solve(status);
     return status;
 }
@@ -2922,7 +3141,7 @@ size_t Searcher::hyper_bin_res_all(const bool check_for_set_values)
 {
     size_t added = 0;
 
-    for(auto const& b: solver->needToAddBinClause) {
+    solver->needToAddBinClause.for_each([&](const BinaryClause& b) {
         lbool val1 = value(b.getLit1());
         lbool val2 = value(b.getLit2());
 
@@ -2935,7 +3154,7 @@ size_t Searcher::hyper_bin_res_all(const bool check_for_set_values)
         if (check_for_set_values
             && (val1 == l_True || val2 == l_True)
         ) {
-            continue;
+            return;
         }
 
         if (check_for_set_values) {
@@ -2946,7 +3165,7 @@ size_t Searcher::hyper_bin_res_all(const bool check_for_set_values)
         *solver->frat << add << ID << b.getLit1() << b.getLit2() << fin;
         solver->attach_bin_clause(b.getLit1(), b.getLit2(), true, ID, false);
         added++;
-    }
+    });
     solver->needToAddBinClause.clear();
 
     return added;
@@ -2958,6 +3177,10 @@ std::pair<size_t, size_t> Searcher::remove_useless_bins(bool except_marked)
     size_t removedRed = 0;
 
     if (conf.doTransRed) {
+        //Same as a set keyed on the literals and redundancy, keeping the
+        //first one found
+        std::stable_sort(uselessBin.begin(), uselessBin.end());
+        uselessBin.erase(std::unique(uselessBin.begin(), uselessBin.end()), uselessBin.end());
         for(auto const& b: uselessBin) {
             propStats.otfHyperTime += 2;
             verb_print(10, "Removing binary clause: " << b
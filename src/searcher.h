@@ -211,6 +211,10 @@ class Searcher : public HyperEngine
     protected:
         Solver* solver;
         lbool search();
+        uint32_t restart_level();
+        bool level0_work_due() const;
+        bool clean_clauses_due() const;
+        bool back_to_level0();
 
         // Distill
         uint64_t next_cls_distill = 0;
@@ -390,6 +394,10 @@ class Searcher : public HyperEngine
         bool litRedundant(Lit p, uint32_t abstract_levels);
         void recursiveConfClauseMin();
         void normalClMinim();
+        void shrink_learnt_clause();
+        vector<uint32_t> shrink_open; ///<Per level, marked literals not yet resolved
+        vector<Lit> shrink_uip; ///<Per level, the block-UIP found
+        vector<std::pair<uint32_t, int32_t>> shrink_chain; ///<Level and ID of the reasons resolved on
         MyStack<Lit> analyze_stack;
         uint32_t abstractLevel(const uint32_t x) const;
         bool subset(const vector<Lit>& A, const Clause& B); //Used for on-the-fly subsumption. Does A subsume B? Uses 'seen' to do its work
@@ -404,6 +412,7 @@ class Searcher : public HyperEngine
         FRIEND_TEST(SearcherTest, pickpolar_neg);
         FRIEND_TEST(SearcherTest, pickpolar_auto);
         FRIEND_TEST(SearcherTest, pickpolar_auto_not_changed_by_simp);
+        FRIEND_TEST(SearcherTest, shrink_block_to_uip);
         #endif
 
         //Clause activites
@@ -54,6 +54,12 @@ SearchStats& SearchStats::operator+=(const SearchStats& other)
     moreMinimLitsStart += other.moreMinimLitsStart;
     moreMinimLitsEnd += other.moreMinimLitsEnd;
     recMinimCost += other.recMinimCost;
+    shrinkAttempt += other.shrinkAttempt;
+    shrinkSuccess += other.shrinkSuccess;
+    shrinkBlocks += other.shrinkBlocks;
+    shrinkBlocksOk += other.shrinkBlocksOk;
+    shrinkLitRem += other.shrinkLitRem;
+    shrinkCost += other.shrinkCost;
 
     //Red stats
     learntUnits += other.learntUnits;
@@ -111,6 +117,12 @@ SearchStats& SearchStats::operator-=(const SearchStats& other)
     moreMinimLitsStart -= other.moreMinimLitsStart;
     moreMinimLitsEnd -= other.moreMinimLitsEnd;
     recMinimCost -= other.recMinimCost;
+    shrinkAttempt -= other.shrinkAttempt;
+    shrinkSuccess -= other.shrinkSuccess;
+    shrinkBlocks -= other.shrinkBlocks;
+    shrinkBlocksOk -= other.shrinkBlocksOk;
+    shrinkLitRem -= other.shrinkLitRem;
+    shrinkCost -= other.shrinkCost;
 
     //Red stats
     learntUnits -= other.learntUnits;
@@ -269,6 +281,30 @@ void SearchStats::print(uint64_t props, bool do_print_times) const
         , "% less overall"
     );
 
+    print_stats_line("c shrink call%"
+        , stats_line_percent(shrinkAttempt, conflicts)
+        , stats_line_percent(shrinkSuccess, shrinkAttempt)
+        , "% attempt successful"
+    );
+
+    print_stats_line("c shrink blocks"
+        , shrinkBlocks
+        , stats_line_percent(shrinkBlocksOk, shrinkBlocks)
+        , "% replaced by block-UIP"
+    );
+
+    print_stats_line("c shrink lits"
+        , shrinkLitRem
+        , stats_line_percent(shrinkLitRem, litsRedNonMin)
+        , "% less overall"
+    );
+
+    print_stats_line("c shrink cost"
+        , shrinkCost
+        , ratio_for_stat(shrinkCost, shrinkAttempt)
+        , "trail lits visited/attempt"
+    );
+
     print_stats_line("c permDiff call%"
         , stats_line_percent(permDiff_attempt, conflicts)
         , stats_line_percent(permDiff_success, permDiff_attempt)
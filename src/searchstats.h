@@ -72,6 +72,12 @@ public:
     uint64_t moreMinimLitsStart = 0;
     uint64_t moreMinimLitsEnd = 0;
     uint64_t recMinimCost = 0;
+    uint64_t shrinkAttempt = 0;
+    uint64_t shrinkSuccess = 0;
+    uint64_t shrinkBlocks = 0;
+    uint64_t shrinkBlocksOk = 0;
+    uint64_t shrinkLitRem = 0;
+    uint64_t shrinkCost = 0;
 
     //Learnt clause stats
     uint64_t learntUnits = 0;
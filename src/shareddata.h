@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <limits>
 using std::vector;
 using std::mutex;
 
@@ -60,6 +61,15 @@ class SharedData
             }
         };
 
+        //Learnt long clauses, in OUTER numbering, stored flat as
+        //[size, glue, origin, lits...]. Entries are only appended, and once
+        //the buffer is over its limit the oldest half is dropped. long_base is
+        //the absolute position of longs[0], so readers' positions stay valid
+        vector<uint32_t> longs;
+        uint64_t long_base = 0;
+        std::mutex long_mutex;
+        static constexpr uint32_t long_origin_remote = std::numeric_limits<uint32_t>::max();
+
         vector<Spec> bins;
         std::mutex bin_mutex;
         vector<lbool> value;
@@ -80,6 +90,11 @@ class SharedData
             }
             return mem;
         }
+
+        size_t calc_memory_use_longs()
+        {
+            return longs.capacity()*sizeof(uint32_t);
+        }
 };
 
 }
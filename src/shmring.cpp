@@ -0,0 +1,119 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "shmring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#if !defined(_MSC_VER)
+#include <sys/mman.h>
+#endif
+
+using namespace CMSat;
+
+ShmRing* ShmRing::create(const uint64_t bytes)
+{
+    #if defined(_MSC_VER)
+    (void)bytes;
+    return nullptr;
+    #else
+    const uint64_t cap = std::max<uint64_t>(bytes/sizeof(uint32_t), 1024);
+    const uint64_t total = sizeof(ShmRing) + cap*sizeof(uint32_t);
+    void* mem = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return nullptr;
+
+    ShmRing* ring = new (mem) ShmRing;
+    ring->write_pos.store(0);
+    ring->winner.store(-1);
+    ring->capacity = cap;
+    ring->mapped_bytes = total;
+    return ring;
+    #endif
+}
+
+void ShmRing::destroy(ShmRing* ring)
+{
+    #if !defined(_MSC_VER)
+    if (ring == nullptr) return;
+    const uint64_t total = ring->mapped_bytes;
+    ring->~ShmRing();
+    munmap(ring, total);
+    #else
+    (void)ring;
+    #endif
+}
+
+bool ShmRing::try_lock()
+{
+    for(uint32_t i = 0; i < 100000; i++) {
+        if (!lock.test_and_set(std::memory_order_acquire)) return true;
+    }
+    return false;
+}
+
+bool ShmRing::push(const vector<uint32_t>& entries)
+{
+    //Entries larger than the ring would immediately lap every reader
+    if (entries.empty() || entries.size() > capacity/2) return true;
+    if (!try_lock()) return false;
+
+    const uint64_t pos = write_pos.load(std::memory_order_relaxed);
+    const uint64_t at = pos % capacity;
+    const uint64_t first = std::min<uint64_t>(entries.size(), capacity - at);
+    memcpy(data() + at, entries.data(), first*sizeof(uint32_t));
+    memcpy(data(), entries.data() + first, (entries.size() - first)*sizeof(uint32_t));
+    write_pos.store(pos + entries.size(), std::memory_order_relaxed);
+
+    unlock();
+    return true;
+}
+
+bool ShmRing::read(uint64_t& pos, vector<uint32_t>& out)
+{
+    out.clear();
+    if (!try_lock()) return false;
+
+    const uint64_t end = write_pos.load(std::memory_order_relaxed);
+    if (end - pos > capacity) pos = end;
+    const uint64_t num = end - pos;
+    if (num == 0) {
+        unlock();
+        return true;
+    }
+    const uint64_t at = pos % capacity;
+    const uint64_t first = std::min<uint64_t>(num, capacity - at);
+    out.resize(num);
+    memcpy(out.data(), data() + at, first*sizeof(uint32_t));
+    memcpy(out.data() + first, data(), (num - first)*sizeof(uint32_t));
+    pos = end;
+
+    unlock();
+    return true;
+}
+
+bool ShmRing::claim_win(const uint32_t id)
+{
+    int32_t expected = -1;
+    return winner.compare_exchange_strong(expected, (int32_t)id) || winner.load() == (int32_t)id;
+}
@@ -0,0 +1,76 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "constants.h"
+
+namespace CMSat {
+
+using std::vector;
+
+// Clause exchange between the processes of the multi-process portfolio.
+// It lives in an anonymous shared mapping made before fork(), so every
+// worker sees the same ring. Entries are [size, glue, origin, lits...] with
+// the lits in OUTER numbering, the same layout as SharedData::longs.
+//
+// Positions are absolute, the data is at pos % capacity. A reader that has
+// been lapped loses what it missed and restarts at the write position.
+// The lock is only ever tried a bounded number of times, so a worker that
+// died holding it can stop the exchange, but not the other workers.
+class DLL_PUBLIC ShmRing
+{
+public:
+    static ShmRing* create(const uint64_t bytes);
+    static void destroy(ShmRing* ring);
+
+    //Both return false if the lock could not be taken
+    bool push(const vector<uint32_t>& entries);
+    bool read(uint64_t& pos, vector<uint32_t>& out);
+
+    //The first worker to finish is the only one that may print its result
+    bool claim_win(const uint32_t id);
+    int32_t get_winner() const { return winner.load(); }
+
+private:
+    ShmRing() = default;
+    bool try_lock();
+    void unlock() { lock.clear(std::memory_order_release); }
+    uint32_t* data() { return reinterpret_cast<uint32_t*>(this+1); }
+
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::atomic<uint64_t> write_pos;
+    std::atomic<int32_t> winner;
+    uint64_t capacity; ///< in uint32_t-s
+    uint64_t mapped_bytes;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+        "Atomics must be lock-free to be shared between processes");
+};
+
+}
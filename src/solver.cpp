@@ -61,6 +61,9 @@ THE SOFTWARE.
 #include "sccfinder.h"
 #include "intree.h"
 #include "satzilla_features_calc.h"
+#include "features_to_reconf.h"
+#include "inprocsched.h"
+#include "membudget.h"
 #include "GitSHA1.h"
 #include "trim.h"
 #include "streambuffer.h"
@@ -128,6 +131,9 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
     datasync = new DataSync(this, nullptr);
     Searcher::solver = this;
     reduceDB = new ReduceDB(this);
+    satzilla_calc = new SatZillaFeaturesCalc(this);
+    inproc_sched = new InprocSched(this);
+    mem_budget = new MemBudget(this);
 
     set_up_sql_writer();
     next_lev1_reduce = conf.every_lev1_reduce;
@@ -154,6 +160,9 @@ Solver::~Solver()
     delete subsumeImplicit;
     delete datasync;
     delete reduceDB;
+    delete satzilla_calc;
+    delete inproc_sched;
+    delete mem_budget;
 #ifdef USE_BREAKID
     delete breakid;
 #endif
@@ -178,6 +187,7 @@ void Solver::set_sqlite(
 }
 
 void Solver::set_shared_data(SharedData* shared_data) { datasync->set_shared_data(shared_data); }
+void Solver::set_shm_ring(ShmRing* ring, const uint32_t proc_id) { datasync->set_shm_ring(ring, proc_id); }
 
 // Only used for unsat, unit, and binary xors during initalization
 void Solver::add_clause_int_frat(const vector<Lit>& cl, const uint32_t id) {
@@ -817,18 +827,18 @@ void Solver::test_renumbering() const
 void Solver::renumber_clauses(const vector<uint32_t>& outer_to_inter)
 {
     //Clauses' abstractions have to be re-calculated
-    for(ClOffset offs: longIrredCls) {
-        Clause* cl = cl_alloc.ptr(offs);
-        updateLitsMap(*cl, outer_to_inter);
-        cl->set_strengthened();
-    }
-
-    for(auto& lredcls: longRedCls) {
-        for(ClOffset off: lredcls) {
-            Clause* cl = cl_alloc.ptr(off);
+    auto upd = [&](const vector<ClOffset>& offs, const size_t from, const size_t to) {
+        for(size_t i = from; i < to; i++) {
+            Clause* cl = cl_alloc.ptr(offs[i]);
             updateLitsMap(*cl, outer_to_inter);
             cl->set_strengthened();
         }
+    };
+    update_in_chunks(longIrredCls.size(), conf.renumber_threads,
+        [&](size_t from, size_t to) { upd(longIrredCls, from, to); });
+    for(const auto& lredcls: longRedCls) {
+        update_in_chunks(lredcls.size(), conf.renumber_threads,
+            [&](size_t from, size_t to) { upd(lredcls, from, to); });
     }
 
     //Clauses' abstractions have to be re-calculated
@@ -1405,6 +1415,13 @@ lbool Solver::solve_with_assumptions(
             !conf.full_simplify_at_startup ? conf.simplify_schedule_startup : conf.simplify_schedule_nonstartup);
     }
 
+    if (status == l_Undef
+        && conf.reconfigure_val != 0
+        && solveStats.num_solve_calls == 1
+    ) {
+        check_reconfigure();
+    }
+
     #ifdef STATS_NEEDED
     if (status == l_Undef) {
         CommunityFinder comm_finder(this);
@@ -1764,9 +1781,14 @@ lbool Solver::execute_inprocess_strategy(
             SLOW_DEBUG_DO(check_assumptions_sanity());
         }
         if (okay()) SLOW_DEBUG_DO(check_wrong_attach());
+        if (!inproc_sched->should_run(token)) continue;
+        if (!mem_budget->allows(token)) continue;
 
-        if (token.substr(0,3) != "occ" && !token.empty())
+        const bool measured = token.substr(0,3) != "occ" && !token.empty();
+        if (measured) {
             verb_print(1, "--> Executing strategy token: " << token);
+            inproc_sched->start(token);
+        }
 
         if (token == "scc-vrepl") {
             if (conf.doFindAndReplaceEqLits) {
@@ -1881,8 +1903,10 @@ lbool Solver::execute_inprocess_strategy(
                 }
             }
         } else if (token == "breakid") {
+            //Symmetry breaking clauses are not implied by the formula, so
+            //there is no FRAT proof for them
             if (conf.doBreakid
-                && frat->enabled()
+                && !frat->enabled()
                 && !conf.simulate_frat
                 && (solveStats.num_simplify == 0 ||
                    (solveStats.num_simplify % conf.breakid_every_n == (conf.breakid_every_n-1)))
@@ -1916,6 +1940,7 @@ lbool Solver::execute_inprocess_strategy(
             cout << "ERROR: strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        if (measured) inproc_sched->finish(token);
 
         SLOW_DEBUG_DO(check_stats());
         if (!okay()) return l_False;
@@ -1948,6 +1973,8 @@ lbool Solver::simplify_problem(const bool startup, const string& strategy) {
     lbool ret = l_Undef;
     clear_order_heap();
     if (!clear_gauss_matrices(false)) return l_False;
+    inproc_sched->new_round(conf.do_adaptive_inproc && !startup);
+    mem_budget->check_before_inprocess();
 
     if (ret == l_Undef) ret = execute_inprocess_strategy(startup, strategy);
     assert(ret != l_True);
@@ -2052,6 +2079,16 @@ void Solver::print_norm_stats(
         , stats_line_percent(reduceDB->get_total_time(), cpu_time)
         , "% time"
     );
+    print_stats_line("c reduceDB lev1 time"
+        , reduceDB->get_lev1_time()
+        , stats_line_percent(reduceDB->get_lev1_time(), cpu_time)
+        , "% time"
+    );
+    print_stats_line("c reduceDB lev2 time"
+        , reduceDB->get_lev2_time()
+        , stats_line_percent(reduceDB->get_lev2_time(), cpu_time)
+        , "% time"
+    );
 
     //OccSimplifier stats
     if (conf.perform_occur_based_simp) {
@@ -2176,6 +2213,8 @@ void Solver::print_full_stats(
     if (conf.doStrSubImplicit) {
         subsumeImplicit->get_stats().print("");
     }
+    inproc_sched->print_stats();
+    mem_budget->print_stats();
     print_mem_stats();
 }
 
@@ -2880,12 +2919,10 @@ uint32_t Solver::num_active_vars() const
     return numActive;
 }
 
-#ifdef STATS_NEEDED
 SatZillaFeatures Solver::calculate_satzilla_features()
 {
     latest_satzilla_feature_calc++;
-    SatZillaFeaturesCalc extract(this);
-    SatZillaFeatures satzilla_feat = extract.extract();
+    SatZillaFeatures satzilla_feat = satzilla_calc->extract();
     satzilla_feat.avg_confl_size = hist.conflSizeHistLT.avg();
     satzilla_feat.avg_confl_glue = hist.glueHistLT.avg();
     satzilla_feat.avg_num_resolutions = hist.numResolutionsHistLT.avg();
@@ -2916,18 +2953,54 @@ SatZillaFeatures Solver::calculate_satzilla_features()
 
     satzilla_feat.num_gates_found_last = sumSearchStats.num_gates_found_last;
     satzilla_feat.num_xors_found_last = sumSearchStats.num_xors_found_last;
+    for(const auto& bnn: bnns) satzilla_feat.num_bnns += (bnn != nullptr);
 
     if (conf.verbosity > 2) {
         satzilla_feat.print_stats();
     }
 
+    #ifdef STATS_NEEDED
     if (sqlStats) {
         sqlStats->satzilla_features(this, this, satzilla_feat);
     }
+    #endif
 
     return satzilla_feat;
 }
-#endif
+
+void Solver::check_reconfigure()
+{
+    if (conf.reconfigure_val != 100) {
+        reconfigure(conf.reconfigure_val);
+        return;
+    }
+
+    const double my_time = cpuTime();
+    const SatZillaFeatures satzilla_feat = calculate_satzilla_features();
+    const vector<int> ranking = get_reconf_ranking(satzilla_feat, conf.verbosity);
+
+    //Every thread takes the next best preset so they don't all run the same
+    //one. Threads past the ranked presets keep their own diversification
+    if (conf.thread_num >= ranking.size()) {
+        verb_print(2, "[reconf] features+ranking T: " << (cpuTime() - my_time)
+            << " best: " << ranking[0] << " thread " << conf.thread_num << " keeps its preset");
+        return;
+    }
+    const unsigned preset = ranking[conf.thread_num];
+    verb_print(2, "[reconf] features+ranking T: " << (cpuTime() - my_time)
+        << " best: " << ranking[0] << " thread " << conf.thread_num << " takes: " << preset);
+    reconfigure(preset);
+}
+
+void Solver::reconfigure(const unsigned preset)
+{
+    //Undo the thread's own diversification preset, then apply the chosen one
+    conf.reset_preset(conf.thread_num % SolverConf::num_presets);
+    conf.apply_preset(preset);
+    polarity_mode = conf.polarity_mode;
+    branch_strategy_change = 0;
+    verb_print(1, "reconfigured solver to config " << preset);
+}
 
 void Solver::check_implicit_stats(const bool onlypairs) const
 {
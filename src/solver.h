@@ -38,9 +38,7 @@ THE SOFTWARE.
 #ifdef CMS_TESTING_ENABLED
 #include "gtest/gtest_prod.h"
 #endif
-#ifdef STATS_NEEDED
 #include "satzilla_features.h"
-#endif
 #define ORACLE_DAT_SIZE 4
 
 namespace CMSat {
@@ -70,10 +68,14 @@ class SubsumeStrengthen;
 class SubsumeImplicit;
 class DataSync;
 class SharedData;
+class ShmRing;
 class ReduceDB;
 class InTree;
 class BreakID;
 class GetClauseQuery;
+class InprocSched;
+class MemBudget;
+struct SatZillaFeaturesCalc;
 
 struct SolveStats
 {
@@ -110,6 +112,7 @@ class Solver : public Searcher
             bool only_indep_solution = false);
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = nullptr, const string* strategy = nullptr);
         void  set_shared_data(SharedData* shared_data);
+        void  set_shm_ring(ShmRing* ring, const uint32_t proc_id);
         vector<Lit> probe_inter_tmp;
         lbool probe_outside(Lit l, uint32_t& min_props);
         void set_max_confl(uint64_t max_confl);
@@ -196,6 +199,9 @@ class Solver : public Searcher
         StrImplWImpl* dist_impl_with_impl = nullptr;
         CardFinder*            card_finder = nullptr;
         GetClauseQuery*        get_clause_query = nullptr;
+        SatZillaFeaturesCalc*  satzilla_calc = nullptr;
+        InprocSched*           inproc_sched = nullptr;
+        MemBudget*             mem_budget = nullptr;
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -342,10 +348,12 @@ class Solver : public Searcher
         //Deleting clauses
         void free_cl(Clause* cl, bool also_remove_clid = true);
         void free_cl(ClOffset offs, bool also_remove_clid = true);
+        SatZillaFeatures calculate_satzilla_features();
+        void check_reconfigure();
+        void reconfigure(const unsigned preset);
         #ifdef STATS_NEEDED
         void stats_del_cl(Clause* cl);
         void stats_del_cl(ClOffset offs);
-        SatZillaFeatures calculate_satzilla_features();
         SatZillaFeatures last_solve_satzilla_feature;
         #endif
 
@@ -357,10 +365,14 @@ class Solver : public Searcher
         PicoSAT* build_picosat();
         void copy_to_simp(SATSolver* s2);
         bool backbone_simpl(int64_t max_confl, bool& finished);
+        #ifdef USE_CADIBACK
+        bool backbone_simpl_cadiback(bool& finished);
+        #endif
         bool removed_var_ext(uint32_t var) const;
 
     private:
         friend class ClauseDumper;
+        friend class MemBudget;
         #ifdef CMS_TESTING_ENABLED
         FRIEND_TEST(SearcherTest, pickpolar_auto_not_changed_by_simp);
         #endif
@@ -395,7 +407,12 @@ class Solver : public Searcher
             }
         };
 
+        //Backbone
+        lbool backbone_search(const Lit assump, const uint64_t max_confl);
+        uint32_t backbone_next_outer_var = 0;
+
         vector<vector<int>> get_irred_cls_for_oracle() const;
+        vector<vector<int>> get_irred_cls_for_oracle_ordered() const;
         vector<vector<uint16_t>> compute_edge_weights() const;
         vector<OracleDat> order_clauses_for_oracle() const;
         void dump_cls_oracle(const string fname, const vector<OracleDat>& cs);
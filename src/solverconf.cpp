@@ -131,6 +131,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , blocking_restart_trail_hist_length(5000)
         , blocking_restart_multip(1.4)
         , fixed_restart_num_confl(100)
+        , keep_assump_levels_on_restart(1)
         , local_glue_multiplier(0.80)
         , shortTermHistorySize (50)
         , lower_bound_for_blocking_restart(10000)
@@ -148,6 +149,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , max_size_more_minim(30)
         , more_red_minim_limit_binary(200)
         , max_num_lits_more_more_red_min(1)
+        , do_shrink(true)
+        , max_glue_shrink(20)
 
         //Verbosity
         , verbosity        (0)
@@ -177,6 +180,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //SQL
         , dump_individual_restarts_and_clauses(true)
+        , satzilla_sample_litsM(20)
         , dump_individual_cldata_ratio(0.01)
         , sql_overwrite_file(0)
         , lock_for_data_gen_ratio(0.1)
@@ -196,6 +200,8 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , varelim_gate_find_limit(800)
         , picosat_gate_limitK(70)
         , varelim_check_resolvent_subs(false)
+        , do_incremental_extend(true)
+        , elimed_cls_mem_limitM(64)
 
         //Subs, str limits for simplifier
         , subsumption_time_limitM(300)
@@ -240,6 +246,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
 
         //Probing
         , do_full_probe    (true)
+        , bit_parallel_probe(true)
         , doIntreeProbe    (true)
         , doTransRed       (true)
         , full_probe_time_limitM(20ULL)
@@ -340,6 +347,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         //Memory savings
         , doRenumberVars   (true)
         , must_renumber    (false)
+        , renumber_threads (1)
         , doSaveMem        (true)
         , full_watch_consolidate_every_n_confl (4ULL*1000ULL*1000ULL) //validated in run 8113323.wlm01
 
@@ -359,16 +367,37 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , global_timeout_multiplier_multiplier(1.1)
         , global_multiplier_multiplier_max(3)
         , var_and_mem_out_mult(1.0)
+        , do_adaptive_inproc(false)
+        , inproc_max_time_ratio(0.4)
+        , max_mem_mb(0)
+        , mem_budget_react_ratio(0.85)
+        , mem_budget_check_every_confl(20000)
 
         //Multi-thread, MPI
         , sync_every_confl(7000) //THREAD syncing
         , every_n_mpi_sync(3) //every N thread sync, we do an MPI sync
+        , do_share_long(1)
+        , share_long_max_size(30)
+        , share_long_max_glue(2)
+        , share_long_lits_limit_K(4000)
         , thread_num(0)
         , is_mpi(false)
 
+        // Backbone
+        , backbone_use_cadiback(false)
+
         // Oracle
         , oracle_get_learnts(false) // get oracle learnt clauses
         , oracle_removed_is_learnt(false) // clauses removed by Oracle should be learnt
+        , oracle_vivif_threads(1)
+        , oracle_vivif_sync_memsM(100)
+        , oracle_vivif_max_time(0)
+
+        //Communities
+        , louvain_threads(1)
+
+        //Reconfiguration
+        , reconfigure_val(0)
 
         //misc
         , origSeed(0)
@@ -426,3 +455,254 @@ DLL_PUBLIC std::string SolverConf::print_times(
 
     return std::string();
 }
+
+//Presets used to diversify the threads, and by reconfiguration
+DLL_PUBLIC void SolverConf::apply_preset(const unsigned preset)
+{
+    switch(preset % num_presets) {
+        case 0: {
+            //default setup
+            break;
+        }
+
+        case 1: {
+            //Minisat-like
+            branch_strategy_setup = "vsids";
+            varElimRatioPerIter = 1;
+            restartType = Restart::geom;
+            polarity_mode = PolarityMode::polarmode_neg;
+
+            inc_max_temp_lev2_red_cls = 1.02;
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
+            break;
+        }
+        case 2: {
+            branch_strategy_setup = "vsids";
+//             polar_best_inv_every_n = 100;
+            break;
+        }
+        case 3: {
+            //Similar to CMS 2.9 except we look at learnt DB size insteead
+            //of conflicts to see if we need to clean.
+            branch_strategy_setup = "vsids";
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.5;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0;
+            glue_put_lev0_if_below_or_eq = 0;
+            inc_max_temp_lev2_red_cls = 1.03;
+            break;
+        }
+        case 4: {
+            //Similar to CMS 5.0
+            branch_strategy_setup = "vsids";
+            varElimRatioPerIter = 0.4;
+            every_lev1_reduce = 0;
+            every_lev2_reduce = 0;
+            do_bva = false;
+            max_temp_lev2_learnt_clauses = 30000;
+            glue_put_lev0_if_below_or_eq = 4;
+
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
+            break;
+        }
+        case 5: {
+            branch_strategy_setup = "vsids";
+            never_stop_search = true;
+            break;
+        }
+        case 6: {
+            //Maple with backtrack
+            branch_strategy_setup = "vsids";
+//             polar_stable_every_n = 10000;
+            break;
+        }
+        case 7: {
+            branch_strategy_setup = "vsids";
+            do_bva = false;
+            glue_put_lev0_if_below_or_eq = 2;
+            varElimRatioPerIter = 1;
+            inc_max_temp_lev2_red_cls = 1.04;
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.1;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.3;
+            break;
+        }
+        case 8: {
+            //Different glue limit
+            branch_strategy_setup = "vmtf";
+            glue_put_lev0_if_below_or_eq = 2;
+            glue_put_lev1_if_below_or_eq = 2;
+            break;
+        }
+        case 9: {
+            branch_strategy_setup = "vsids";
+//             polar_stable_every_n = 1;
+            break;
+        }
+        case 10: {
+            branch_strategy_setup = "vsids";
+            polarity_mode = PolarityMode::polarmode_pos;
+//             polar_stable_every_n = 100000;
+            break;
+        }
+        case 11: {
+            branch_strategy_setup = "vsids";
+            varElimRatioPerIter = 1;
+            restartType = Restart::geom;
+
+            inc_max_temp_lev2_red_cls = 1.01;
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.3;
+            break;
+        }
+        case 12: {
+            branch_strategy_setup = "vmtf";
+            inc_max_temp_lev2_red_cls = 1.001;
+//             polar_stable_every_n = 7;
+//             polar_best_inv_every_n = 6;
+            break;
+        }
+
+        case 13: {
+            //Minisat-like
+            varElimRatioPerIter = 1;
+            restartType = Restart::geom;
+            polarity_mode = PolarityMode::polarmode_neg;
+
+            inc_max_temp_lev2_red_cls = 1.02;
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
+            break;
+        }
+        case 14: {
+            //Different glue limit
+            branch_strategy_setup = "vsids";
+            do_bva = false;
+            doMinimRedMoreMore = 1;
+            glue_put_lev0_if_below_or_eq = 4;
+            //glue_put_lev2_if_below_or_eq = 8;
+            max_num_lits_more_more_red_min = 3;
+            max_glue_more_minim = 4;
+            break;
+        }
+        case 15: {
+            //Similar to CMS 2.9 except we look at learnt DB size insteead
+            //of conflicts to see if we need to clean.
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0.5;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0;
+            glue_put_lev0_if_below_or_eq = 0;
+            inc_max_temp_lev2_red_cls = 1.03;
+//             polar_stable_every_n = 2;
+            break;
+        }
+        case 16: {
+            //Similar to CMS 5.0
+            varElimRatioPerIter = 0.4;
+            every_lev1_reduce = 0;
+            every_lev2_reduce = 0;
+            max_temp_lev2_learnt_clauses = 30000;
+            glue_put_lev0_if_below_or_eq = 4;
+
+            ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = 0;
+            ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = 0.5;
+            break;
+        }
+        case 17: {
+            //max_temporary_learnt_clauses = 10000;
+            do_bva = true;
+            break;
+        }
+        case 18: {
+            branch_strategy_setup = "vsids";
+            every_lev1_reduce = 0;
+            every_lev2_reduce = 0;
+            glue_put_lev1_if_below_or_eq = 0;
+            max_temp_lev2_learnt_clauses = 10000;
+            break;
+        }
+
+        case 19: {
+            do_bva = false;
+            doMinimRedMoreMore = 0;
+            orig_global_timeout_multiplier = 5;
+            num_conflicts_of_search_inc = 1.15;
+            more_red_minim_limit_binary = 600;
+            max_num_lits_more_more_red_min = 20;
+//             polar_stable_every_n = 4;
+            //max_temporary_learnt_clauses = 10000;
+            break;
+        }
+
+        case 20: {
+            //Luby
+            branch_strategy_setup = "vmtf";
+            restart_inc = 1.5;
+            restart_first = 100;
+            restartType = Restart::luby;
+//             polar_stable_every_n = 2;
+            break;
+        }
+
+        case 21: {
+            branch_strategy_setup = "vsids";
+            glue_put_lev0_if_below_or_eq = 3;
+            glue_put_lev1_if_below_or_eq = 5;
+            break;
+        }
+
+        case 22: {
+            branch_strategy_setup = "vmtf";
+            doMinimRedMoreMore = 0;
+            orig_global_timeout_multiplier = 5;
+            num_conflicts_of_search_inc = 1.15;
+            more_red_minim_limit_binary = 600;
+            max_num_lits_more_more_red_min = 20;
+            //max_temporary_learnt_clauses = 10000;
+            break;
+        }
+
+        default: {
+            varElimRatioPerIter = 0.1*(preset % 9);
+            if (preset % 4 == 0) {
+                restartType = Restart::glue;
+            }
+            if (preset % 5 == 0) {
+                restartType = Restart::geom;
+            }
+            restart_first = 100 * (0.5*(preset % 5));
+            doMinimRedMoreMore = ((preset % 5) == 1);
+            break;
+        }
+    }
+}
+
+//Sets the values the preset changed back to their defaults
+DLL_PUBLIC void SolverConf::reset_preset(const unsigned preset)
+{
+    const SolverConf def;
+    SolverConf touched;
+    touched.apply_preset(preset);
+    if (touched.branch_strategy_setup != def.branch_strategy_setup) branch_strategy_setup = def.branch_strategy_setup;
+    if (touched.varElimRatioPerIter != def.varElimRatioPerIter) varElimRatioPerIter = def.varElimRatioPerIter;
+    if (touched.restartType != def.restartType) restartType = def.restartType;
+    if (touched.polarity_mode != def.polarity_mode) polarity_mode = def.polarity_mode;
+    if (touched.inc_max_temp_lev2_red_cls != def.inc_max_temp_lev2_red_cls) inc_max_temp_lev2_red_cls = def.inc_max_temp_lev2_red_cls;
+    for(uint32_t i = 0; i < 2; i++) {
+        if (touched.ratio_keep_clauses[i] != def.ratio_keep_clauses[i]) ratio_keep_clauses[i] = def.ratio_keep_clauses[i];
+    }
+    if (touched.glue_put_lev0_if_below_or_eq != def.glue_put_lev0_if_below_or_eq) glue_put_lev0_if_below_or_eq = def.glue_put_lev0_if_below_or_eq;
+    if (touched.glue_put_lev1_if_below_or_eq != def.glue_put_lev1_if_below_or_eq) glue_put_lev1_if_below_or_eq = def.glue_put_lev1_if_below_or_eq;
+    if (touched.every_lev1_reduce != def.every_lev1_reduce) every_lev1_reduce = def.every_lev1_reduce;
+    if (touched.every_lev2_reduce != def.every_lev2_reduce) every_lev2_reduce = def.every_lev2_reduce;
+    if (touched.do_bva != def.do_bva) do_bva = def.do_bva;
+    if (touched.max_temp_lev2_learnt_clauses != def.max_temp_lev2_learnt_clauses) max_temp_lev2_learnt_clauses = def.max_temp_lev2_learnt_clauses;
+    if (touched.never_stop_search != def.never_stop_search) never_stop_search = def.never_stop_search;
+    if (touched.doMinimRedMoreMore != def.doMinimRedMoreMore) doMinimRedMoreMore = def.doMinimRedMoreMore;
+    if (touched.max_num_lits_more_more_red_min != def.max_num_lits_more_more_red_min) max_num_lits_more_more_red_min = def.max_num_lits_more_more_red_min;
+    if (touched.max_glue_more_minim != def.max_glue_more_minim) max_glue_more_minim = def.max_glue_more_minim;
+    if (touched.orig_global_timeout_multiplier != def.orig_global_timeout_multiplier) orig_global_timeout_multiplier = def.orig_global_timeout_multiplier;
+    if (touched.num_conflicts_of_search_inc != def.num_conflicts_of_search_inc) num_conflicts_of_search_inc = def.num_conflicts_of_search_inc;
+    if (touched.more_red_minim_limit_binary != def.more_red_minim_limit_binary) more_red_minim_limit_binary = def.more_red_minim_limit_binary;
+    if (touched.restart_inc != def.restart_inc) restart_inc = def.restart_inc;
+    if (touched.restart_first != def.restart_first) restart_first = def.restart_first;
+}
@@ -195,6 +195,7 @@ class GaussConf
         , max_matrix_rows(2000)
         , min_matrix_rows(3)
         , max_num_matrices(5)
+        , m4ri_min_cells(100000)
     {
     }
 
@@ -204,6 +205,7 @@ class GaussConf
     uint32_t max_matrix_rows; //The maximum matrix size -- no. of rows
     uint32_t min_matrix_rows; //The minimum matrix size -- no. of rows
     uint32_t max_num_matrices; //Maximum number of matrices
+    uint64_t m4ri_min_cells; //Initial elimination of matrices with at least this many cells is table-based
 
     //Matrix extraction config
     bool doMatrixFind = true;
@@ -215,6 +217,9 @@ class DLL_PUBLIC SolverConf
 {
     public:
         SolverConf();
+        static constexpr unsigned num_presets = 23;
+        void apply_preset(const unsigned preset);
+        void reset_preset(const unsigned preset);
         std::string print_times(
             const double time_used
             , const bool time_out
@@ -284,6 +289,7 @@ class DLL_PUBLIC SolverConf
         unsigned blocking_restart_trail_hist_length;
         double   blocking_restart_multip;
         uint32_t fixed_restart_num_confl;
+        int      keep_assump_levels_on_restart; ///<Don't re-decide the assumptions at every restart
 
 
         double   local_glue_multiplier;
@@ -303,6 +309,8 @@ class DLL_PUBLIC SolverConf
         unsigned max_size_more_minim;
         unsigned more_red_minim_limit_binary;
         unsigned max_num_lits_more_more_red_min;
+        int      do_shrink; ///<Replace the literals of a level in the learnt clause with their block-UIP
+        unsigned max_glue_shrink;
 
         //Verbosity
         int  verbosity;  ///<Verbosity level 0-2: normal  3+ extreme
@@ -332,6 +340,7 @@ class DLL_PUBLIC SolverConf
 
         //SQL
         bool      dump_individual_restarts_and_clauses;
+        uint64_t  satzilla_sample_litsM; ///< Over this many irred lits, satzilla features are sampled
         double    dump_individual_cldata_ratio;
         int       sql_overwrite_file;
         double    lock_for_data_gen_ratio;
@@ -351,6 +360,8 @@ class DLL_PUBLIC SolverConf
         int varelim_gate_find_limit;
         int picosat_gate_limitK;
         int varelim_check_resolvent_subs;
+        int do_incremental_extend; ///<Only re-extend elimed vars whose inputs changed since last model
+        uint64_t elimed_cls_mem_limitM; ///<Spill the oldest elimed clauses to a temporary file over this. 0 == no limit
 
         //Subs, str limits for simplifier
         long long subsumption_time_limitM;
@@ -394,6 +405,7 @@ class DLL_PUBLIC SolverConf
 
         //Probing
         int      do_full_probe;
+        int      bit_parallel_probe; ///<Filter bin-only probes through 64-wide bitmask propagation
         int      doIntreeProbe;
         int      doTransRed;   ///<carry out transitive reduction
         unsigned long long   full_probe_time_limitM;
@@ -476,6 +488,7 @@ class DLL_PUBLIC SolverConf
         //Memory savings
         int       doRenumberVars;
         int       must_renumber; ///< if set, all "renumber" is treated as a "must-renumber"
+        uint32_t  renumber_threads; ///< threads rewriting the clauses and watchlists when renumbering
         int       doSaveMem;
         uint64_t  full_watch_consolidate_every_n_confl;
         int must_always_conslidate = 0; // only used for debugging
@@ -505,16 +518,37 @@ class DLL_PUBLIC SolverConf
         double global_timeout_multiplier_multiplier;
         double global_multiplier_multiplier_max;
         double var_and_mem_out_mult;
+        int    do_adaptive_inproc; ///< Skip and re-budget inprocessing tokens based on their measured payoff
+        double inproc_max_time_ratio; ///< Over this ratio of time spent inprocessing, only run the tokens paying off best
+        uint64_t max_mem_mb; ///< Memory budget for the accounted components. 0 == no budget
+        double mem_budget_react_ratio; ///< Start saving memory over this ratio of max_mem_mb
+        uint64_t mem_budget_check_every_confl;
 
         //Multi-thread, MPI
         unsigned long long sync_every_confl;
         uint32_t every_n_mpi_sync;
+        int      do_share_long; ///< Share learnt long clauses between threads and MPI ranks
+        uint32_t share_long_max_size;
+        uint32_t share_long_max_glue;
+        uint64_t share_long_lits_limit_K; ///< Max size of the shared long clause buffer
         unsigned thread_num;
         uint32_t is_mpi;
 
+        // Backbone
+        int backbone_use_cadiback; // copy the CNF to CadiBack instead of using our own search
+
         // Oracle
         int oracle_get_learnts; // get oracle learnt clauses
         int oracle_removed_is_learnt; // clauses removed by Oracle should be learnt
+        uint32_t oracle_vivif_threads; // number of Oracle workers in oracle-vivif
+        long long oracle_vivif_sync_memsM; // workers exchange strengthened clauses every N M mems
+        double oracle_vivif_max_time; // wall-clock budget of oracle-vivif, 0 = unlimited
+
+        //Communities
+        uint32_t louvain_threads; // threads building the edges of the variable-interaction graph
+
+        //Reconfiguration
+        int reconfigure_val; // 0 = never, 1..22 = switch to this preset, 100 = pick preset from satzilla features
 
         //Misc
         unsigned origSeed;
@@ -523,4 +557,7 @@ class DLL_PUBLIC SolverConf
         int      conf_needed = true;
 };
 
+//Diversifies the config of the thread_num-th thread (or process) of a portfolio
+DLL_PUBLIC void update_config(SolverConf& conf, unsigned thread_num);
+
 } //end namespace
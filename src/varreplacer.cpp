@@ -777,6 +777,15 @@ void VarReplacer::extend_model(const uint32_t var)
         set_sub_var_during_solution_extension(var, sub_var);
 }
 
+//NOTE: 'var' is OUTER. Unsets var and the vars it replaces
+void VarReplacer::unset_model(const uint32_t var)
+{
+    solver->model[var] = l_Undef;
+    auto it = reverseTable.find(var);
+    if (it == reverseTable.end()) return;
+    for(const uint32_t sub_var: it->second) solver->model[sub_var] = l_Undef;
+}
+
 void VarReplacer::extend_pop_queue(vector<Lit>& pop)
 {
     vector<Lit> extra;
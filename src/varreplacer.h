@@ -61,6 +61,7 @@ class VarReplacer
 
         void extend_model_already_set();
         void extend_model_all();
+        void unset_model(const uint32_t var);
         void extend_model(const uint32_t var);
         void extend_pop_queue(vector<Lit>& pop);
 
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include <iostream>
 #include <limits>
 #include <set>
+#include <thread>
 
 using std::numeric_limits;
 
@@ -34,12 +35,26 @@ namespace CMSat {
 uint32_t getUpdatedVar(uint32_t toUpdate, const vector< uint32_t >& mapper);
 Lit getUpdatedLit(Lit toUpdate, const vector< uint32_t >& mapper);
 
+//toUpdate[i] = old toUpdate[mapper[i]], in place by following the cycles of
+//the permutation, so only a bit per element is allocated
 template<typename T>
 void updateArray(T& toUpdate, const vector< uint32_t >& mapper)
 {
-    T backup = toUpdate;
+    assert(mapper.size() >= toUpdate.size());
+    vector<bool> done(toUpdate.size());
     for(size_t i = 0; i < toUpdate.size(); i++) {
-        toUpdate.at(i) = backup.at(mapper.at(i));
+        if (done[i]) continue;
+        typename T::value_type tmp = std::move(toUpdate[i]);
+        size_t j = i;
+        while(true) {
+            done[j] = true;
+            const size_t from = mapper[j];
+            assert(from < toUpdate.size());
+            if (from == i) break;
+            toUpdate[j] = std::move(toUpdate[from]);
+            j = from;
+        }
+        toUpdate[j] = std::move(tmp);
     }
 }
 
@@ -56,11 +71,9 @@ void updateArrayRev(T& toUpdate, const vector< uint32_t >& mapper)
 template<typename T>
 void updateArrayMapCopy(T& toUpdate, const vector< uint32_t >& mapper)
 {
-    //assert(toUpdate.size() == mapper.size());
-    T backup = toUpdate;
     for(size_t i = 0; i < toUpdate.size(); i++) {
-        if (backup[i] < mapper.size()) {
-            toUpdate[i] = mapper[backup[i]];
+        if (toUpdate[i] < mapper.size()) {
+            toUpdate[i] = mapper[toUpdate[i]];
         }
     }
 }
@@ -92,7 +105,8 @@ inline Lit getUpdatedLit(Lit toUpdate, const vector< uint32_t >& mapper)
 
 inline uint32_t getUpdatedVar(uint32_t toUpdate, const vector< uint32_t >& mapper)
 {
-    return mapper.at(toUpdate);
+    assert(toUpdate < mapper.size());
+    return mapper[toUpdate];
 }
 
 inline uint32_t getUpdatedVarMaxToMax(uint32_t toUpdate, const vector< uint32_t >& mapper)
@@ -100,7 +114,8 @@ inline uint32_t getUpdatedVarMaxToMax(uint32_t toUpdate, const vector< uint32_t
     if (toUpdate == numeric_limits<uint32_t>::max()) {
         return numeric_limits<uint32_t>::max();
     }
-    return mapper.at(toUpdate);
+    assert(toUpdate < mapper.size());
+    return mapper[toUpdate];
 }
 
 template<typename T, typename T2>
@@ -109,7 +124,7 @@ inline void updateBySwap(T& toUpdate, T2& seen, const vector< uint32_t >& mapper
     assert(toUpdate.size() <= mapper.size());
     assert(toUpdate.size() <= seen.size());
     for(size_t i = 0; i < toUpdate.size(); i++) {
-        if (seen.at(i)) {
+        if (seen[i]) {
             //Already updated, skip
             continue;
         }
@@ -118,17 +133,17 @@ inline void updateBySwap(T& toUpdate, T2& seen, const vector< uint32_t >& mapper
         uint32_t var = i;
         const uint32_t origStart = var;
         while(true) {
-            uint32_t swapwith = mapper.at(var);
-            assert(seen.at(swapwith) == 0);
+            uint32_t swapwith = mapper[var];
+            assert(seen[swapwith] == 0);
             //std::cout << "Swapping " << var << " with " << swapwith << std::endl;
             using std::swap;
             swap(toUpdate[var], toUpdate[swapwith]);
-            seen.at(swapwith) = 1;
+            seen[swapwith] = 1;
             var = swapwith;
 
             //Full circle
-            if (mapper.at(var) == origStart) {
-                seen.at(mapper.at(var)) = 1;
+            if (mapper[var] == origStart) {
+                seen[mapper[var]] = 1;
                 break;
             }
         }
@@ -136,9 +151,29 @@ inline void updateBySwap(T& toUpdate, T2& seen, const vector< uint32_t >& mapper
 
     //clear seen
     for(size_t i = 0; i < toUpdate.size(); i++) {
-        assert(seen.at(i) == 1);
-        seen.at(i) = 0;
+        assert(seen[i] == 1);
+        seen[i] = 0;
+    }
+}
+
+//Calls func(from, to) on disjoint chunks of [0, n) from num_threads threads.
+//Small jobs are done in the calling thread
+template<typename F>
+void update_in_chunks(const size_t n, const uint32_t num_threads, F func)
+{
+    const size_t min_chunk = 50000;
+    const size_t threads = std::min<size_t>(std::max<uint32_t>(num_threads, 1), n/min_chunk);
+    if (threads <= 1) {
+        func((size_t)0, n);
+        return;
+    }
+
+    vector<std::thread> ts;
+    for(size_t t = 1; t < threads; t++) {
+        ts.push_back(std::thread(func, (n*t)/threads, (n*(t+1))/threads));
     }
+    func((size_t)0, n/threads);
+    for(auto& t: ts) t.join();
 }
 
 } //end namespace
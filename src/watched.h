@@ -50,6 +50,11 @@ enum BNNPropType {
     , bnn_out_t = 2
 };
 
+// Binary clause IDs don't fit into data2, the bits above them are stored in
+// the top of data1. Literals never use these bits, var_Undef is 28 bits
+#define WATCH_LIT_BITS 29
+#define WATCH_ID_LOW_BITS (EFFECTIVELY_USEABLE_BITS-2)
+
 class Watched {
     public:
         Watched(Watched const&) = default;
@@ -101,9 +106,10 @@ class Watched {
         Watched(const Lit lit, const bool red, int32_t ID) :
             data1(lit.toInt())
             , type(static_cast<int>(WatchType::watch_binary_t))
-            , data2((int32_t)red | ID<<2) //marking is 2nd bit
         {
-            assert(ID < 1LL<< (EFFECTIVELY_USEABLE_BITS-2) && "Please compile with -DLARGEMEM");
+            assert(ID >= 0);
+            assert(lit.toInt() < (1U << WATCH_LIT_BITS));
+            set_ID_red(ID, red);
         }
 
         /**
@@ -165,7 +171,7 @@ class Watched {
         Lit lit2() const
         {
             DEBUG_WATCHED_DO(assert(isBin()));
-            return Lit::toLit(data1);
+            return Lit::toLit(data1 & ((1U << WATCH_LIT_BITS)-1));
         }
 
         /**
@@ -174,7 +180,7 @@ class Watched {
         void setLit2(const Lit lit)
         {
             DEBUG_WATCHED_DO(assert(isBin()));
-            data1 = lit.toInt();
+            data1 = (data1 & ~((1U << WATCH_LIT_BITS)-1)) | lit.toInt();
         }
 
         bool red() const
@@ -186,12 +192,14 @@ class Watched {
         int32_t get_ID() const
         {
             DEBUG_WATCHED_DO(assert(isBin()));
-            return data2 >> 2;
+            uint64_t ID = data2 >> 2;
+            ID |= (uint64_t)(data1 >> WATCH_LIT_BITS) << WATCH_ID_LOW_BITS;
+            return ID;
         }
         void set_ID(const int32_t ID)
         {
             DEBUG_WATCHED_DO(assert(isBin()));
-            data2 = (int32_t)red() | ID<<2;
+            set_ID_red(ID, red());
         }
 
         void setRed(const bool toSet)
@@ -263,6 +271,15 @@ class Watched {
         }
 
     private:
+        //marking is 2nd bit of data2
+        void set_ID_red(const int32_t ID, const bool red)
+        {
+            const uint64_t low_mask = (1ULL << WATCH_ID_LOW_BITS)-1;
+            data2 = (ClOffset)red | (ClOffset)(((uint64_t)ID & low_mask) << 2);
+            data1 = (data1 & ((1U << WATCH_LIT_BITS)-1))
+                | (uint32_t)(((uint64_t)ID >> WATCH_ID_LOW_BITS) << WATCH_LIT_BITS);
+        }
+
         uint32_t data1;
         ClOffset type:2;
         ClOffset data2:EFFECTIVELY_USEABLE_BITS;
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "test_helper.h"
 #include <vector>
 #include <algorithm>
+#include <random>
 using std::vector;
 using namespace CMSat;
 
@@ -210,6 +211,96 @@ TEST_F(assump_interf, only_assump)
     EXPECT_EQ( ret, l_False);
 }
 
+TEST_F(assump_interf, minimize_conflict)
+{
+    s->new_vars(6);
+    s->add_clause(vector<Lit>{Lit(0, true), Lit(1, true)});
+    s->add_clause(vector<Lit>{Lit(2, true), Lit(4, false)});
+    s->add_clause(vector<Lit>{Lit(3, true), Lit(5, false)});
+    s->add_clause(vector<Lit>{Lit(4, true), Lit(5, true), Lit(0, true)});
+    for(uint32_t i = 0; i < 4; i++) assumps.push_back(Lit(i, false));
+    lbool ret = s->solve(&assumps);
+    EXPECT_EQ( ret, l_False);
+
+    vector<Lit> core;
+    EXPECT_TRUE( s->minimize_conflict(core));
+    EXPECT_TRUE( core.size() == 2 || core.size() == 3);
+
+    //Every literal is needed
+    for(size_t i = 0; i < core.size(); i++) {
+        assumps.clear();
+        for(size_t j = 0; j < core.size(); j++) if (j != i) assumps.push_back(~core[j]);
+        EXPECT_EQ( s->solve(&assumps), l_True);
+    }
+    assumps.clear();
+    for(const Lit l: core) assumps.push_back(~l);
+    EXPECT_EQ( s->solve(&assumps), l_False);
+}
+
+// Random 3-SAT near the threshold: every clause is guarded by one of the
+// selector variables, so assuming all selectors gives the full formula.
+// Large enough to go through many restarts with the assumption levels kept.
+static void add_guarded_3sat(SATSolver* s, const uint32_t vars, const uint32_t cls
+    , const uint32_t sels, const uint32_t seed)
+{
+    std::mt19937 rnd(seed);
+    s->new_vars(vars+sels);
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < cls; i++) {
+        cl.clear();
+        while(cl.size() < 3) {
+            const Lit l(rnd() % vars, rnd() % 2);
+            if (std::find_if(cl.begin(), cl.end(),
+                [&](const Lit x) {return x.var() == l.var();}) == cl.end()) cl.push_back(l);
+        }
+        cl.push_back(Lit(vars + i % sels, true));
+        s->add_clause(cl);
+    }
+}
+
+static lbool solve_guarded_3sat(const int keep, const uint32_t vars, const uint32_t cls
+    , const uint64_t confl_budget, vector<Lit>& conflict)
+{
+    SolverConf conf;
+    conf.keep_assump_levels_on_restart = keep;
+    SATSolver s(&conf);
+    const uint32_t sels = 20;
+    add_guarded_3sat(&s, vars, cls, sels, 7);
+    vector<Lit> assumps;
+    for(uint32_t i = 0; i < sels; i++) assumps.push_back(Lit(vars+i, false));
+
+    //Solve in small slices, so the search runs out of budget while the
+    //assumption levels are kept
+    lbool ret = l_Undef;
+    while(ret == l_Undef) {
+        s.set_max_confl(confl_budget);
+        ret = s.solve(&assumps);
+    }
+    if (ret == l_True) {
+        for(const Lit l: assumps) EXPECT_EQ(s.get_model()[l.var()], l_True);
+    } else {
+        conflict = s.get_conflict();
+        for(const Lit l: conflict) EXPECT_TRUE(l.var() >= vars && l.sign());
+    }
+    EXPECT_GT(s.get_sum_conflicts(), 1000u);
+    return ret;
+}
+
+TEST(assump_restarts, keep_levels_sat)
+{
+    vector<Lit> conflict;
+    EXPECT_EQ(solve_guarded_3sat(1, 250, 1050, 300, conflict), l_True);
+    EXPECT_EQ(solve_guarded_3sat(0, 250, 1050, 300, conflict), l_True);
+}
+
+TEST(assump_restarts, keep_levels_unsat)
+{
+    vector<Lit> conflict;
+    EXPECT_EQ(solve_guarded_3sat(1, 150, 750, 300, conflict), l_False);
+    EXPECT_FALSE(conflict.empty());
+    EXPECT_EQ(solve_guarded_3sat(0, 150, 750, 300, conflict), l_False);
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -27,8 +27,12 @@ THE SOFTWARE.
 
 #include "cryptominisat5/cryptominisat.h"
 #include "src/solverconf.h"
+#include "src/cnfbinreader.h"
 #include "test_helper.h"
 #include <vector>
+#include <set>
+#include <random>
+#include <sstream>
 
 using namespace CMSat;
 using std::vector;
@@ -1372,6 +1376,367 @@ TEST(xor_recovery, DISABLED_find_xor_renumber)
     EXPECT_EQ(xors[0].first, str_to_vars("2, 3, 4, 5, 6, 7,8, 9, 10"));
 }
 
+//The output becomes FALSE at level 0 after the BNN was attached, so cleaning
+//flips its literals. Any single TRUE input is still fine.
+TEST(bnn, out_false_at_level_zero)
+{
+    SATSolver s;
+    s.new_vars(5);
+    s.add_bnn_clause(str_to_cl("1, 2, 3, 4"), 2, Lit(4, false));
+    s.add_clause(str_to_cl("-5"));
+    s.simplify();
+
+    for(uint32_t i = 0; i < 4; i++) {
+        vector<Lit> assumps = {Lit(i, false)};
+        ASSERT_EQ(s.solve(&assumps), l_True);
+        uint32_t num_true = 0;
+        for(uint32_t v = 0; v < 4; v++) num_true += (s.get_model()[v] == l_True);
+        EXPECT_EQ(num_true, 1U);
+    }
+    vector<Lit> assumps = str_to_cl("1, 2");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+}
+
+TEST(maxsat, weighted)
+{
+    SATSolver s;
+    s.new_vars(3);
+    s.add_clause(str_to_cl("-1, -2"));
+    s.add_clause(str_to_cl("-2, -3"));
+    s.add_clause(str_to_cl("-1, -3"));
+
+    vector<std::pair<Lit, uint64_t>> soft;
+    soft.push_back({Lit(0, false), 3});
+    soft.push_back({Lit(1, false), 5});
+    soft.push_back({Lit(2, false), 4});
+    uint64_t cost;
+    vector<lbool> model;
+    lbool ret = s.solve_maxsat(soft, cost, model);
+    EXPECT_EQ(ret, l_True);
+    EXPECT_EQ(cost, 7U);
+    EXPECT_EQ(model[1], l_True);
+}
+
+TEST(maxsat, unsat)
+{
+    SATSolver s;
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1"));
+    s.add_clause(str_to_cl("-1"));
+
+    vector<std::pair<Lit, uint64_t>> soft;
+    soft.push_back({Lit(1, false), 1});
+    uint64_t cost;
+    vector<lbool> model;
+    lbool ret = s.solve_maxsat(soft, cost, model);
+    EXPECT_EQ(ret, l_False);
+    EXPECT_TRUE(model.empty());
+}
+
+TEST(maxsat, multi_thread_throws)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(2);
+    s.add_clause(str_to_cl("-1, -2"));
+
+    vector<std::pair<Lit, uint64_t>> soft;
+    soft.push_back({Lit(0, false), 1});
+    soft.push_back({Lit(1, false), 1});
+    uint64_t cost;
+    vector<lbool> model;
+    EXPECT_THROW(s.solve_maxsat(soft, cost, model), std::runtime_error);
+}
+
+//Groups of variables with at-most-one constraints and a weighted soft unit on
+//each member, so the optimum keeps the heaviest member of every group. A
+//satisfiable random 3-SAT part over the same variables and some extra ones
+//forces real search, and the many different weights force many strata.
+TEST(maxsat, weighted_groups)
+{
+    const uint32_t groups = 25;
+    const uint32_t group_sz = 4;
+    const uint32_t extra = 150;
+    const uint32_t nvars = groups*group_sz + extra;
+    std::mt19937 mtrand(3);
+
+    //Planted solution: the heaviest of each group is TRUE, extra vars random
+    vector<bool> planted(nvars, false);
+    vector<std::pair<Lit, uint64_t>> soft;
+    uint64_t expected = 0;
+    for(uint32_t g = 0; g < groups; g++) {
+        uint64_t best = 0;
+        uint32_t best_at = 0;
+        for(uint32_t i = 0; i < group_sz; i++) {
+            const uint32_t v = g*group_sz + i;
+            const uint64_t w = 1 + mtrand() % 40;
+            soft.push_back({Lit(v, false), w});
+            expected += w;
+            if (w > best) {
+                best = w;
+                best_at = v;
+            }
+        }
+        expected -= best;
+        planted[best_at] = true;
+    }
+    for(uint32_t v = groups*group_sz; v < nvars; v++) planted[v] = mtrand() % 2;
+
+    vector<vector<Lit>> hard;
+    for(uint32_t g = 0; g < groups; g++) {
+        for(uint32_t i = 0; i < group_sz; i++) {
+            for(uint32_t j = i+1; j < group_sz; j++) {
+                hard.push_back({Lit(g*group_sz+i, true), Lit(g*group_sz+j, true)});
+            }
+        }
+    }
+    for(uint32_t i = 0; i < nvars*4; i++) {
+        vector<Lit> cl;
+        bool sat = false;
+        while(cl.size() < 3) {
+            const uint32_t v = mtrand() % nvars;
+            bool dup = false;
+            for(const Lit l: cl) dup |= (l.var() == v);
+            if (dup) continue;
+            const Lit l(v, mtrand() % 2);
+            sat |= (planted[v] != l.sign());
+            cl.push_back(l);
+        }
+        if (sat) hard.push_back(cl);
+    }
+
+    SATSolver s;
+    s.set_verbosity(1);
+    s.new_vars(nvars);
+    for(const auto& cl: hard) s.add_clause(cl);
+
+    uint64_t cost;
+    vector<lbool> model;
+    testing::internal::CaptureStdout();
+    const lbool ret = s.solve_maxsat(soft, cost, model);
+    const string out = testing::internal::GetCapturedStdout();
+    ASSERT_EQ(ret, l_True);
+    EXPECT_EQ(cost, expected);
+
+    ASSERT_GE(model.size(), nvars);
+    for(const auto& cl: hard) {
+        bool sat = false;
+        for(const Lit l: cl) sat |= (model[l.var()] == (l.sign() ? l_False : l_True));
+        EXPECT_TRUE(sat);
+    }
+    uint64_t model_cost = 0;
+    for(const auto& sf: soft) if (model[sf.first.var()] != l_True) model_cost += sf.second;
+    EXPECT_EQ(model_cost, cost);
+
+    //One core per group at least, and the search did restart
+    const size_t at = out.find("c [maxsat] finished:");
+    ASSERT_NE(at, string::npos);
+    const size_t cores_at = out.find(" cores: ", at);
+    ASSERT_NE(cores_at, string::npos);
+    EXPECT_GE(std::stoul(out.substr(cores_at + 8)), groups);
+    EXPECT_GT(s.get_sum_conflicts(), 100U);
+    uint32_t restarts = 0;
+    for(size_t pos = out.find("\nc rst "); pos != string::npos; pos = out.find("\nc rst ", pos+1)) {
+        restarts++;
+    }
+    EXPECT_GT(restarts, 1U);
+}
+
+//A constraint as (is_xor, sorted lits or vars, rhs), XORs with their rhs
+//unfolded from the signs of the literals
+typedef std::tuple<bool, vector<uint32_t>, bool> NormCl;
+static NormCl norm_cl(vector<Lit> lits, const bool is_xor, bool rhs)
+{
+    vector<uint32_t> x;
+    for(Lit& l: lits) {
+        if (is_xor) {
+            rhs ^= l.sign();
+            l = Lit(l.var(), false);
+        }
+        x.push_back(l.toInt());
+    }
+    std::sort(x.begin(), x.end());
+    return NormCl(is_xor, x, is_xor ? rhs : true);
+}
+
+struct ClsRecorder {
+    uint32_t nVars() const { return num_vars; }
+    void new_vars(uint32_t n) { num_vars += n; }
+    bool add_clause(const vector<Lit>& lits) {
+        cls.insert(norm_cl(lits, false, true));
+        return true;
+    }
+    bool add_xor_clause(const vector<Lit>& lits, bool rhs) {
+        cls.insert(norm_cl(lits, true, rhs));
+        return true;
+    }
+    uint32_t num_vars = 0;
+    std::multiset<NormCl> cls;
+};
+
+static std::multiset<NormCl> read_dimacs_cls(const std::string& fname)
+{
+    std::multiset<NormCl> ret;
+    std::ifstream in(fname);
+    std::string line;
+    while(std::getline(in, line)) {
+        if (line.empty() || line[0] == 'p' || line[0] == 'c') continue;
+        std::istringstream ss(line);
+        const bool is_xor = line[0] == 'x';
+        if (is_xor) ss.get();
+        vector<Lit> lits;
+        int l;
+        while(ss >> l && l != 0) lits.push_back(Lit(std::abs(l)-1, l < 0));
+        ret.insert(norm_cl(lits, is_xor, true));
+    }
+    return ret;
+}
+
+static void add_dump_test_cnf(SATSolver& s, const uint32_t vars, const uint32_t cls, const uint32_t seed)
+{
+    std::mt19937 mtrand(seed);
+    s.new_vars(vars);
+    for(uint32_t i = 0; i < cls; i++) {
+        vector<Lit> cl;
+        for(uint32_t j = 0; j < 3; j++) cl.push_back(Lit(mtrand() % vars, mtrand() % 2));
+        s.add_clause(cl);
+    }
+    for(uint32_t i = 0; i < 10; i++) {
+        vector<uint32_t> x;
+        for(uint32_t j = 0; j < 4; j++) x.push_back(mtrand() % vars);
+        std::sort(x.begin(), x.end());
+        x.erase(std::unique(x.begin(), x.end()), x.end());
+        s.add_xor_clause(x, mtrand() % 2);
+    }
+}
+
+//Dumps the simplified CNF in both formats, reads them back and checks that
+//they hold exactly what get_next_constraint() gives, and that they solve the
+//same as the original
+static void check_dump_reread(const uint32_t vars, const uint32_t cls, const uint32_t seed)
+{
+    SATSolver s;
+    add_dump_test_cnf(s, vars, cls, seed);
+    s.simplify();
+
+    std::multiset<NormCl> expected;
+    s.start_getting_constraints(false, true);
+    vector<Lit> lits; bool is_xor; bool rhs;
+    while(s.get_next_constraint(lits, is_xor, rhs)) expected.insert(norm_cl(lits, is_xor, rhs));
+    s.end_getting_constraints();
+
+    const std::string txt = "dump_reread_test.cnf";
+    const std::string bin = "dump_reread_test.cnfb";
+    ASSERT_TRUE(s.dump_irred_clauses(txt, true, false));
+    ASSERT_TRUE(s.dump_irred_clauses(bin, true, true));
+    EXPECT_TRUE(CNFBinReader<SATSolver>::is_binary_cnf(bin));
+    EXPECT_FALSE(CNFBinReader<SATSolver>::is_binary_cnf(txt));
+
+    EXPECT_EQ(read_dimacs_cls(txt), expected);
+    ClsRecorder rec;
+    CNFBinReader<ClsRecorder> rec_reader(&rec);
+    ASSERT_TRUE(rec_reader.parse(bin));
+    EXPECT_EQ(rec.cls, expected);
+    EXPECT_EQ(rec_reader.num_cls, expected.size());
+
+    SATSolver from_bin;
+    CNFBinReader<SATSolver> reader(&from_bin);
+    ASSERT_TRUE(reader.parse(bin));
+
+    SATSolver orig;
+    add_dump_test_cnf(orig, vars, cls, seed);
+    const lbool ret = orig.solve();
+    EXPECT_EQ(from_bin.solve(), ret);
+    EXPECT_EQ(s.solve(), ret);
+
+    std::remove(txt.c_str());
+    std::remove(bin.c_str());
+}
+
+TEST(dump_interface, simplified_reread_sat)
+{
+    check_dump_reread(300, 900, 1);
+    check_dump_reread(300, 1100, 2);
+}
+
+TEST(dump_interface, simplified_reread_unsat)
+{
+    check_dump_reread(100, 600, 3);
+}
+
+TEST(dump_interface, binary_reader_rejects_truncated)
+{
+    SATSolver s;
+    add_dump_test_cnf(s, 50, 150, 4);
+    const std::string bin = "dump_trunc_test.cnfb";
+    ASSERT_TRUE(s.dump_irred_clauses(bin, false, true));
+
+    std::ifstream in(bin, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    ASSERT_GT(data.size(), 20U);
+    std::ofstream out(bin, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size()-3);
+    out.close();
+
+    SATSolver s2;
+    CNFBinReader<SATSolver> reader(&s2);
+    EXPECT_FALSE(reader.parse(bin));
+    std::remove(bin.c_str());
+}
+
+//Random 3-SAT plus some long clauses with redundant literals for the oracle
+//to vivify
+static vector<vector<Lit>> oracle_test_cnf(const uint32_t vars, const uint32_t cls, const uint32_t seed)
+{
+    std::mt19937 mtrand(seed);
+    vector<vector<Lit>> ret;
+    for(uint32_t i = 0; i < cls; i++) {
+        vector<Lit> cl;
+        for(uint32_t j = 0; j < 3; j++) cl.push_back(Lit(mtrand() % vars, mtrand() % 2));
+        ret.push_back(cl);
+    }
+    for(uint32_t i = 0; i < cls/10; i++) {
+        vector<Lit> cl = ret[mtrand() % cls];
+        for(uint32_t j = 0; j < 4; j++) cl.push_back(Lit(mtrand() % vars, mtrand() % 2));
+        ret.push_back(cl);
+    }
+    return ret;
+}
+
+static lbool solve_after_oracle_vivif(
+    const vector<vector<Lit>>& cnf, const uint32_t vars,
+    const uint32_t solver_threads, const uint32_t vivif_threads)
+{
+    SATSolver s;
+    s.set_num_threads(solver_threads);
+    s.set_oracle_vivif_threads(vivif_threads);
+    s.new_vars(vars);
+    for(const auto& cl: cnf) s.add_clause(cl);
+
+    const std::string strategy = "oracle-vivif";
+    s.simplify(nullptr, &strategy);
+    const lbool ret = s.solve();
+    if (ret == l_True) {
+        for(const auto& cl: cnf) {
+            bool sat = false;
+            for(const Lit l: cl) sat |= (s.get_model()[l.var()] ^ l.sign()) == l_True;
+            EXPECT_TRUE(sat);
+        }
+    }
+    return ret;
+}
+
+TEST(oracle_vivif, same_result_any_vivif_threads)
+{
+    struct Inst { uint32_t vars; uint32_t cls; uint32_t seed; };
+    for(const auto& inst: vector<Inst>{{150, 570, 1}, {150, 600, 2}, {120, 600, 3}, {150, 700, 4}}) {
+        const auto cnf = oracle_test_cnf(inst.vars, inst.cls, inst.seed);
+        const lbool ret = solve_after_oracle_vivif(cnf, inst.vars, 1, 1);
+        EXPECT_EQ(solve_after_oracle_vivif(cnf, inst.vars, 1, 4), ret);
+        EXPECT_EQ(solve_after_oracle_vivif(cnf, inst.vars, 2, 4), ret);
+    }
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,64 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "src/solver.h"
+#include "src/binimplgraph.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+TEST(binimplgraph_test, assigned_node_after_edges)
+{
+    SolverConf conf;
+
+    std::unique_ptr<std::atomic<bool>> tmp(new std::atomic<bool>(false));
+    Solver s(&conf, tmp.get());
+    s.new_vars(5);
+    s.add_clause_outside(str_to_cl("1, 2"));
+    s.add_clause_outside(str_to_cl("-1, 3"));
+    s.add_clause_outside(str_to_cl("4, 5"));
+    s.add_clause_outside(str_to_cl("5"));
+
+    BinImplGraph g;
+    g.build(&s);
+    EXPECT_EQ(g.num_nodes(), 10U);
+    EXPECT_EQ(g.num_edges(), 4U);
+    EXPECT_EQ(g.num_succ(Lit(4, false).toInt()), 0U);
+    EXPECT_EQ(g.num_succ(Lit(4, true).toInt()), 0U);
+    EXPECT_EQ(g.num_succ(Lit(3, true).toInt()), 0U);
+
+    const uint32_t* at = g.begin(Lit(0, true).toInt());
+    ASSERT_EQ(g.num_succ(Lit(0, true).toInt()), 1U);
+    EXPECT_EQ(*at, Lit(1, false).toInt());
+    at = g.begin(Lit(0, false).toInt());
+    ASSERT_EQ(g.num_succ(Lit(0, false).toInt()), 1U);
+    EXPECT_EQ(*at, Lit(2, false).toInt());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
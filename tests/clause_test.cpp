@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include "src/clause.h"
+#include "src/watched.h"
 #include <sstream>
 #include <stdlib.h>
 
@@ -75,6 +76,48 @@ TEST_F(F, convert_to_string2)
     free(tmp);
 }
 
+// The high bits of binary clause IDs are kept above the literal in data1,
+// so all of them must survive changing the literal, the ID and the flags
+TEST(watched, bin_ID_high_bits)
+{
+    const vector<int32_t> IDs = {
+        0, 1, (1 << 27) - 1, 1 << 28, (1 << 28) + 5, 0x5a5a5a5a, std::numeric_limits<int32_t>::max()};
+    const vector<Lit> lits = {Lit(0, false), Lit(12345, true), Lit((1U << 28) - 1, true)};
+    for(const int32_t ID: IDs) {
+        for(const Lit lit: lits) {
+            for(const bool red: {false, true}) {
+                Watched w(lit, red, ID);
+                EXPECT_TRUE(w.isBin());
+                EXPECT_EQ(w.lit2(), lit);
+                EXPECT_EQ(w.get_ID(), ID);
+                EXPECT_EQ(w.red(), red);
+                EXPECT_FALSE(w.bin_cl_marked());
+
+                w.mark_bin_cl();
+                const Lit other = Lit(lit.var() / 2, !lit.sign());
+                w.setLit2(other);
+                EXPECT_EQ(w.lit2(), other);
+                EXPECT_EQ(w.get_ID(), ID);
+                EXPECT_TRUE(w.bin_cl_marked());
+
+                w.set_ID(ID / 3);
+                EXPECT_EQ(w.get_ID(), ID / 3);
+                EXPECT_EQ(w.lit2(), other);
+                EXPECT_EQ(w.red(), red);
+
+                w.unmark_bin_cl();
+                if (red) w.setRed(false);
+                else w.setReallyRed();
+                EXPECT_EQ(w.red(), !red);
+                EXPECT_EQ(w.get_ID(), ID / 3);
+                EXPECT_EQ(w.lit2(), other);
+                EXPECT_FALSE(w.bin_cl_marked());
+                EXPECT_EQ(w, Watched(other, !red, ID / 3));
+            }
+        }
+    }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
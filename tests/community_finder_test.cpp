@@ -0,0 +1,151 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <set>
+#include <random>
+
+#include "src/solver.h"
+#include "src/community_finder.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+struct community : public ::testing::Test {
+    community()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+    }
+    ~community()
+    {
+        delete s;
+    }
+
+    // Planted partition: groups of vars with many ternary clauses inside a
+    // group and few across groups. The last var is in no clause
+    void add_planted(const uint32_t seed)
+    {
+        std::mt19937 rnd(seed);
+        s->new_vars(groups*per_group+1);
+        auto rnd_lit = [&](uint32_t group) {
+            return Lit(group*per_group + rnd() % per_group, rnd() % 2);
+        };
+        for(uint32_t g = 0; g < groups; g++) {
+            for(uint32_t i = 0; i < 150; i++) {
+                vector<Lit> cl;
+                while(cl.size() < 3) {
+                    const Lit l = rnd_lit(g);
+                    bool dup = false;
+                    for(const Lit l2: cl) dup |= l2.var() == l.var();
+                    if (!dup) cl.push_back(l);
+                }
+                s->add_clause_outside(cl);
+            }
+        }
+        for(uint32_t i = 0; i < 20; i++) {
+            const uint32_t g1 = rnd() % groups;
+            const uint32_t g2 = (g1 + 1 + rnd() % (groups-1)) % groups;
+            s->add_clause_outside(vector<Lit>{rnd_lit(g1), rnd_lit(g1), rnd_lit(g2)});
+        }
+    }
+
+    // Every group is (almost) entirely in its own community
+    void check_recovered(const vector<uint32_t>& comm)
+    {
+        ASSERT_EQ(comm.size(), groups*per_group+1);
+        EXPECT_EQ(comm.back(), numeric_limits<uint32_t>::max());
+        std::set<uint32_t> dominants;
+        for(uint32_t g = 0; g < groups; g++) {
+            std::map<uint32_t, uint32_t> count;
+            for(uint32_t v = g*per_group; v < (g+1)*per_group; v++) {
+                ASSERT_NE(comm[v], numeric_limits<uint32_t>::max());
+                count[comm[v]]++;
+            }
+            uint32_t best = 0;
+            uint32_t best_comm = 0;
+            for(const auto& c: count) if (c.second > best) {
+                best = c.second;
+                best_comm = c.first;
+            }
+            EXPECT_GE(best, per_group*9/10) << "group: " << g;
+            dominants.insert(best_comm);
+        }
+        EXPECT_EQ(dominants.size(), groups);
+    }
+
+    SolverConf conf;
+    Solver* s = nullptr;
+    std::atomic<bool> must_inter;
+    const uint32_t groups = 6;
+    const uint32_t per_group = 30;
+};
+
+TEST_F(community, planted_partition)
+{
+    for(uint32_t seed = 1; seed <= 5; seed++) {
+        delete s;
+        s = new Solver(&conf, &must_inter);
+        add_planted(seed);
+        CommunityFinder finder(s);
+        check_recovered(finder.find_communities());
+        EXPECT_GE(finder.num_comms, groups);
+        EXPECT_GE(finder.levels, 1u);
+    }
+}
+
+TEST_F(community, planted_partition_threads)
+{
+    conf.louvain_threads = 4;
+    s = new Solver(&conf, &must_inter);
+    add_planted(7);
+    CommunityFinder finder(s);
+    check_recovered(finder.find_communities());
+}
+
+// Only binaries, two cliques joined by a single edge
+TEST_F(community, two_cliques_of_binaries)
+{
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(12);
+    for(uint32_t base: {0U, 6U}) {
+        for(uint32_t a = base; a < base+6; a++) {
+            for(uint32_t b = a+1; b < base+6; b++) {
+                s->add_clause_outside(vector<Lit>{Lit(a, false), Lit(b, true)});
+            }
+        }
+    }
+    s->add_clause_outside(str_to_cl("1, 7"));
+    CommunityFinder finder(s);
+    const vector<uint32_t> comm = finder.find_communities();
+    ASSERT_EQ(comm.size(), 12u);
+    for(uint32_t v = 1; v < 6; v++) EXPECT_EQ(comm[v], comm[0]);
+    for(uint32_t v = 7; v < 12; v++) EXPECT_EQ(comm[v], comm[6]);
+    EXPECT_NE(comm[0], comm[6]);
+    EXPECT_EQ(finder.num_comms, 2u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
 using std::set;
 
 #include "src/solver.h"
@@ -168,6 +169,111 @@ TEST_F(intree, trans_red_and_hyper_bin_1)
     check_red_cls_contains(s, "-3, 6");
 }
 
+// The hyper-binary resolvents and the useless binaries used to be kept in
+// std::set-s. The values below were recorded with that version: the
+// flat buffers must add and remove the very same binaries
+// Result of intree probing a random instance of 2- and 3-clauses
+struct IntreeResult {
+    uint32_t units;
+    uint32_t irred_bins;
+    uint32_t red_bins;
+    uint64_t bins_hash;
+};
+
+static IntreeResult intree_random(const uint32_t seed)
+{
+    std::atomic<bool> must_inter(false);
+    SolverConf conf;
+    conf.do_hyperbin_and_transred = true;
+    Solver s(&conf, &must_inter);
+    std::mt19937 rnd(seed);
+    const uint32_t n = 40 + seed*5;
+    s.new_vars(n);
+    for(uint32_t i = 0; i < n*0.9; i++) {
+        const uint32_t a = rnd()%n, b = rnd()%n;
+        if (a == b) continue;
+        EXPECT_TRUE(s.add_clause_outside({Lit(a, rnd()%2), Lit(b, rnd()%2)}));
+    }
+    for(uint32_t i = 0; i < n*1.2; i++) {
+        const uint32_t a = rnd()%n, b = rnd()%n, c = rnd()%n;
+        if (a == b || b == c || a == c) continue;
+        EXPECT_TRUE(s.add_clause_outside({Lit(a, rnd()%2), Lit(b, rnd()%2), Lit(c, rnd()%2)}));
+    }
+    EXPECT_TRUE(s.intree->intree_probe());
+
+    IntreeResult r = {(uint32_t)s.get_zero_assigned_lits().size(), 0, 0, 0};
+    for(uint32_t i = 0; i < s.nVars()*2; i++) {
+        const Lit l = Lit::toLit(i);
+        for(const Watched& w: s.watches[l]) {
+            if (!w.isBin() || w.lit2() < l) continue;
+            if (w.red()) r.red_bins++;
+            else r.irred_bins++;
+            r.bins_hash += (l.toInt()*1000003ULL + w.lit2().toInt())*(2 + w.red());
+        }
+    }
+    return r;
+}
+
+TEST(intree_random, same_bins_as_set_version)
+{
+    const vector<std::pair<uint32_t, IntreeResult>> expected = {
+        {1, {7, 40, 13, 4017019159ULL}},
+        {2, {40, 45, 18, 4184021387ULL}},
+        {3, {3, 45, 20, 5666028318ULL}},
+        {4, {8, 53, 35, 7725041221ULL}},
+        {5, {10, 58, 28, 9564048627ULL}},
+        {6, {17, 62, 14, 7830038900ULL}},
+        {7, {3, 68, 25, 11444056058ULL}},
+        {8, {18, 64, 30, 11571057079ULL}},
+        {9, {29, 75, 36, 13960071326ULL}},
+        {10, {16, 73, 25, 13200067219ULL}},
+        {11, {30, 72, 12, 10193051447ULL}},
+        {12, {2, 87, 20, 17287084725ULL}},
+    };
+    for(const auto& e: expected) {
+        const IntreeResult r = intree_random(e.first);
+        EXPECT_EQ(r.units, e.second.units) << "seed " << e.first;
+        EXPECT_EQ(r.irred_bins, e.second.irred_bins) << "seed " << e.first;
+        EXPECT_EQ(r.red_bins, e.second.red_bins) << "seed " << e.first;
+        EXPECT_EQ(r.bins_hash, e.second.bins_hash) << "seed " << e.first;
+    }
+}
+
+TEST(hyper_bin_buffer, same_as_set)
+{
+    std::mt19937 rnd(3);
+    for(uint32_t iter = 0; iter < 50; iter++) {
+        HyperBinBuffer buf;
+        set<BinaryClause> model;
+        set<BinaryClause> used;
+        vector<BinaryClause> pushed;
+        uint32_t ID = 1;
+        for(uint32_t i = 0; i < 200; i++) {
+            if (pushed.empty() || rnd() % 3 != 0) {
+                const uint32_t a = rnd() % 50;
+                const BinaryClause b(Lit(a, rnd() % 2), Lit(a + 1 + rnd() % 50, rnd() % 2), true, ID);
+                ID += 1 + rnd() % 3;
+                //Within one BFS a pair of literals is never resolved twice
+                if (!used.insert(b).second) continue;
+                buf.push(b);
+                model.insert(b);
+                pushed.push_back(b);
+            } else {
+                //Also removes ones already removed
+                const BinaryClause& b = pushed[rnd() % pushed.size()];
+                EXPECT_EQ(buf.remove(b), model.erase(b) == 1);
+            }
+            ASSERT_EQ(buf.size(), model.size());
+            EXPECT_EQ(buf.empty(), model.empty());
+        }
+        set<BinaryClause> got;
+        buf.for_each([&](const BinaryClause& b) { EXPECT_TRUE(got.insert(b).second); });
+        EXPECT_EQ(got, model);
+        buf.clear();
+        EXPECT_TRUE(buf.empty());
+    }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
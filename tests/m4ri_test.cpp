@@ -0,0 +1,127 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+#include <algorithm>
+
+#include "src/solver.h"
+#include "src/gaussian.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+
+namespace CMSat {
+
+struct ElimResult {
+    vector<vector<char>> rows; //columns, then rhs
+    vector<vector<char>> reason_mat;
+    vector<char> var_has_resp_row;
+};
+
+//Some rows are the XOR of two earlier ones, so that there are rows
+//without a pivot, too
+static vector<Xor> random_xors(
+    std::mt19937& mtrand, const uint32_t num_vars, const uint32_t num_xors, const uint32_t max_size)
+{
+    vector<Xor> xors;
+    vector<uint32_t> vars(num_vars);
+    for(uint32_t i = 0; i < num_vars; i++) vars[i] = i;
+    for(uint32_t i = 0; i < num_xors; i++) {
+        vector<uint32_t> x;
+        if (i >= 2 && mtrand() % 5 == 0) {
+            vector<char> in(num_vars, 0);
+            for(uint32_t v: xors[mtrand() % i]) in[v] ^= 1;
+            for(uint32_t v: xors[mtrand() % i]) in[v] ^= 1;
+            for(uint32_t v = 0; v < num_vars; v++) if (in[v]) x.push_back(v);
+        }
+        if (x.empty()) {
+            std::shuffle(vars.begin(), vars.end(), mtrand);
+            const uint32_t sz = 2 + mtrand() % (max_size-1);
+            x.assign(vars.begin(), vars.begin() + sz);
+        }
+        xors.push_back(Xor(x, mtrand() % 2));
+    }
+    return xors;
+}
+
+TEST(m4ri, same_as_textbook_elimination)
+{
+    struct Shape { uint32_t vars; uint32_t xors; uint32_t max_size; };
+    const vector<Shape> shapes = {
+        {30, 20, 5},
+        {90, 60, 8},
+        {100, 150, 6},
+        {400, 200, 20},
+        {300, 300, 150},
+    };
+
+    //Only the test is a friend of EGaussian
+    auto get_result = [](const EGaussian& g) {
+        ElimResult r;
+        for(uint32_t row = 0; row < g.num_rows; row++) {
+            vector<char> bits;
+            for(uint32_t col = 0; col < g.num_cols; col++) bits.push_back(g.mat[row][col]);
+            bits.push_back(g.mat[row].rhs());
+            r.rows.push_back(bits);
+        }
+        r.reason_mat = g.reason_mat;
+        r.var_has_resp_row = g.var_has_resp_row;
+        return r;
+    };
+
+    std::mt19937 mtrand(17);
+    for(const auto& sh: shapes) {
+        for(uint32_t iter = 0; iter < 4; iter++) {
+            SolverConf conf;
+            std::atomic<bool> must_inter(false);
+            Solver s(&conf, &must_inter);
+            s.new_vars(sh.vars);
+            EGaussian g(&s, 0, random_xors(mtrand, sh.vars, sh.xors, sh.max_size));
+
+            s.conf.gaussconf.m4ri_min_cells = std::numeric_limits<uint64_t>::max();
+            g.fill_matrix();
+            g.eliminate();
+            const ElimResult textbook = get_result(g);
+
+            g.fill_matrix();
+            g.eliminate_m4ri();
+            const ElimResult m4ri = get_result(g);
+
+            ASSERT_EQ(textbook.rows.size(), m4ri.rows.size());
+            for(uint32_t row = 0; row < textbook.rows.size(); row++) {
+                EXPECT_EQ(textbook.rows[row], m4ri.rows[row])
+                    << "shape " << sh.vars << "x" << sh.xors << " row " << row;
+            }
+            EXPECT_EQ(textbook.reason_mat, m4ri.reason_mat);
+            EXPECT_EQ(textbook.var_has_resp_row, m4ri.var_has_resp_row);
+        }
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
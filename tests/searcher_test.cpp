@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
 using std::set;
 
 #include "src/solver.h"
@@ -106,6 +107,109 @@ TEST_F(SearcherTest, pickpolar_neg)
     ASSERT_EQ(num, 0U);
 }
 
+
+//Level 1 decides g (var 1), level 2 decides a (var 2) and propagates
+//b (var 3), c (var 4) from a alone, and b' (var 6) from a and g. Level 3
+//decides e (var 5).
+TEST_F(SearcherTest, shrink_block_to_uip)
+{
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(30);
+    ss = (Searcher*)s;
+    s->add_clause_outside(str_to_cl("-2, 3"));
+    s->add_clause_outside(str_to_cl("-2, 4"));
+    s->add_clause_outside(str_to_cl("-2, -1, 6"));
+
+    //Only the test is a friend of Searcher. The learnt clause is ~e, then
+    //the given literals. Returns the literals other than ~e, sorted
+    auto shrink = [&](const string& lits) {
+        for(const Lit l: str_to_cl("1, 2, 5")) {
+            s->new_decision_level();
+            s->enqueue<false>(l);
+            EXPECT_TRUE(s->propagate<false>().isnullptr());
+        }
+        ss->learnt_clause = str_to_cl("-5");
+        for(const Lit l: str_to_cl(lits)) ss->learnt_clause.push_back(l);
+        ss->shrink_learnt_clause();
+        EXPECT_EQ(ss->learnt_clause[0], str_to_cl("-5")[0]);
+        vector<Lit> ret(ss->learnt_clause.begin()+1, ss->learnt_clause.end());
+        ss->learnt_clause.clear();
+        s->cancelUntil(0);
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+
+    //b and c of level 2 are replaced by a
+    EXPECT_EQ(shrink("-3, -4"), str_to_cl("-2"));
+
+    //b' also needs g of level 1, which is not in the clause
+    EXPECT_EQ(shrink("-3, -6"), str_to_cl("-3, -6"));
+
+    //Now g is in the clause, so the block can be shrunk
+    EXPECT_EQ(shrink("-3, -6, -1"), str_to_cl("-1, -2"));
+
+    //A single literal on its level is left alone
+    EXPECT_EQ(shrink("-3, -1"), str_to_cl("-1, -3"));
+
+    EXPECT_EQ(ss->stats.shrinkAttempt, 4u);
+    EXPECT_EQ(ss->stats.shrinkSuccess, 2u);
+    EXPECT_EQ(ss->stats.shrinkLitRem, 2u);
+}
+
+//Shrinking must not change the answer, and it must actually shrink
+TEST_F(SearcherTest, shrink_keeps_answers)
+{
+    for(const bool shrink: {false, true}) {
+        conf.do_shrink = shrink;
+
+        //Pigeon hole, 7 pigeons in 6 holes, UNSAT
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(7*6);
+        for(uint32_t p = 0; p < 7; p++) {
+            vector<Lit> cl;
+            for(uint32_t h = 0; h < 6; h++) cl.push_back(Lit(p*6+h, false));
+            s->add_clause_outside(cl);
+        }
+        for(uint32_t h = 0; h < 6; h++) {
+            for(uint32_t p1 = 0; p1 < 7; p1++) {
+                for(uint32_t p2 = p1+1; p2 < 7; p2++) {
+                    s->add_clause_outside({Lit(p1*6+h, true), Lit(p2*6+h, true)});
+                }
+            }
+        }
+        EXPECT_EQ(s->solve_with_assumptions(), l_False);
+        if (shrink) {
+            EXPECT_GT(s->get_stats().shrinkSuccess, 0u);
+            EXPECT_GT(s->get_stats().shrinkLitRem, 0u);
+        } else {
+            EXPECT_EQ(s->get_stats().shrinkAttempt, 0u);
+        }
+        delete s;
+        s = nullptr;
+
+        //Random 3-SAT under the threshold, SAT
+        std::mt19937 rnd(11);
+        vector<vector<Lit>> cls;
+        must_inter.store(false);
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(300);
+        for(uint32_t i = 0; i < 1200; i++) {
+            vector<Lit> cl;
+            for(uint32_t k = 0; k < 3; k++) cl.push_back(Lit(rnd() % 300, rnd() % 2));
+            s->add_clause_outside(cl);
+            cls.push_back(cl);
+        }
+        ASSERT_EQ(s->solve_with_assumptions(), l_True);
+        for(const auto& cl: cls) {
+            bool sat = false;
+            for(const Lit l: cl) sat |= s->get_model()[l.var()] == boolToLBool(!l.sign());
+            EXPECT_TRUE(sat);
+        }
+        delete s;
+        s = nullptr;
+        must_inter.store(false);
+    }
+}
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,220 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/shmring.h"
+
+#include <vector>
+#if !defined(_MSC_VER)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using std::vector;
+using namespace CMSat;
+
+#if !defined(_MSC_VER)
+
+// The smallest ring, 1024 uint32_t-s
+struct shmring : public ::testing::Test {
+    shmring() { ring = ShmRing::create(0); }
+    ~shmring() { ShmRing::destroy(ring); }
+    ShmRing* ring = nullptr;
+};
+
+static vector<uint32_t> entry(const uint32_t sz, const uint32_t start)
+{
+    vector<uint32_t> ret;
+    for(uint32_t i = 0; i < sz; i++) ret.push_back(start+i);
+    return ret;
+}
+
+TEST_F(shmring, push_read)
+{
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_TRUE(out.empty());
+
+    EXPECT_TRUE(ring->push(entry(10, 0)));
+    EXPECT_TRUE(ring->push(entry(5, 100)));
+    EXPECT_TRUE(ring->read(pos, out));
+    vector<uint32_t> expect = entry(10, 0);
+    for(uint32_t x: entry(5, 100)) expect.push_back(x);
+    EXPECT_EQ(out, expect);
+    EXPECT_EQ(pos, 15u);
+
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(shmring, wraparound)
+{
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    //300 does not divide 1024, so entries get split at the end of the ring
+    for(uint32_t i = 0; i < 20; i++) {
+        EXPECT_TRUE(ring->push(entry(300, i*1000)));
+        EXPECT_TRUE(ring->read(pos, out));
+        EXPECT_EQ(out, entry(300, i*1000));
+    }
+    EXPECT_EQ(pos, 20*300u);
+}
+
+TEST_F(shmring, lapped_reader_restarts)
+{
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    for(uint32_t i = 0; i < 4; i++) EXPECT_TRUE(ring->push(entry(300, i*1000)));
+
+    //1200 written into 1024, the oldest entry is gone
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(pos, 1200u);
+
+    EXPECT_TRUE(ring->push(entry(7, 5)));
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_EQ(out, entry(7, 5));
+}
+
+TEST_F(shmring, full_but_not_lapped)
+{
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    for(uint32_t i = 0; i < 2; i++) EXPECT_TRUE(ring->push(entry(512, i*1000)));
+
+    //Exactly the capacity, everything is still there
+    EXPECT_TRUE(ring->read(pos, out));
+    vector<uint32_t> expect = entry(512, 0);
+    for(uint32_t x: entry(512, 1000)) expect.push_back(x);
+    EXPECT_EQ(out, expect);
+}
+
+TEST_F(shmring, oversized_entry_dropped)
+{
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    EXPECT_TRUE(ring->push(entry(513, 0)));
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(pos, 0u);
+}
+
+TEST_F(shmring, across_fork)
+{
+    const pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        ring->push(entry(10, 42));
+        _exit(ring->claim_win(1) ? 0 : 1);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_EQ(out, entry(10, 42));
+    EXPECT_EQ(ring->get_winner(), 1);
+    EXPECT_FALSE(ring->claim_win(0));
+    EXPECT_TRUE(ring->claim_win(1));
+}
+
+// Pigeonhole, "pigeons" pigeons into "holes" holes
+static void add_php(SATSolver& s, const uint32_t pigeons, const uint32_t holes)
+{
+    s.new_vars(pigeons*holes);
+    auto v = [&](uint32_t p, uint32_t h) {return Lit(p*holes+h, false);};
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) cl.push_back(v(p, h));
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{~v(p1, h), ~v(p2, h)});
+            }
+        }
+    }
+}
+
+// Two processes solve the same instance, exchanging clauses through the
+// ring. Returns what the processes exited with.
+static vector<int> solve_in_procs(ShmRing* ring, const uint32_t pigeons, const uint32_t holes)
+{
+    vector<pid_t> pids;
+    for(uint32_t i = 0; i < 2; i++) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            SATSolver s;
+            s.set_shm_exchange(ring, i);
+            s.set_default_polarity(i == 0);
+            add_php(s, pigeons, holes);
+            const lbool ret = s.solve();
+            _exit(ret == l_True ? 10 : (ret == l_False ? 20 : 0));
+        }
+        pids.push_back(pid);
+    }
+
+    vector<int> ret;
+    for(const pid_t pid: pids) {
+        int status;
+        if (pid == -1 || waitpid(pid, &status, 0) == -1 || !WIFEXITED(status)) {
+            ret.push_back(-1);
+        } else {
+            ret.push_back(WEXITSTATUS(status));
+        }
+    }
+    return ret;
+}
+
+TEST(shmring_procs, php_unsat)
+{
+    ShmRing* ring = ShmRing::create(1024*1024);
+    EXPECT_EQ(solve_in_procs(ring, 8, 7), (vector<int>{20, 20}));
+
+    //Something was exchanged
+    uint64_t pos = 0;
+    vector<uint32_t> out;
+    EXPECT_TRUE(ring->read(pos, out));
+    EXPECT_FALSE(out.empty());
+    ShmRing::destroy(ring);
+}
+
+TEST(shmring_procs, php_sat)
+{
+    ShmRing* ring = ShmRing::create(1024*1024);
+    EXPECT_EQ(solve_in_procs(ring, 7, 7), (vector<int>{10, 10}));
+    ShmRing::destroy(ring);
+}
+
+#endif
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,10 +23,19 @@ THE SOFTWARE.
 #include "gtest/gtest.h"
 
 #include <set>
+#include <random>
 using std::set;
 
 #include "src/solver.h"
 #include "src/solverconf.h"
+#include "src/occsimplifier.h"
+#include "src/datasync.h"
+#include "src/shareddata.h"
+#include "src/varupdatehelper.h"
+#include "src/reducedb.h"
+#include "src/membudget.h"
+#include "src/inprocsched.h"
+#include "src/features_to_reconf.h"
 using namespace CMSat;
 #include "test_helper.h"
 
@@ -282,6 +291,1004 @@ TEST_F(SolverTest, get_irred_bin_and_long)
     s->end_getting_constraints();
 }
 
+
+// Random 3-SAT well below the threshold, so BVE eliminates most variables
+static vector<vector<Lit>> add_easy_3sat(Solver* s, const uint32_t vars, const uint32_t cls)
+{
+    std::mt19937 rnd(3);
+    vector<vector<Lit>> ret;
+    s->new_vars(vars);
+    for(uint32_t i = 0; i < cls; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const Lit l(rnd() % vars, rnd() % 2);
+            bool dup = false;
+            for(const Lit x: cl) dup |= x.var() == l.var();
+            if (!dup) cl.push_back(l);
+        }
+        s->add_clause_outside(cl);
+        ret.push_back(cl);
+    }
+    return ret;
+}
+
+static void check_model(const Solver* s, const vector<vector<Lit>>& cls)
+{
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) sat |= s->get_model()[l.var()] == boolToLBool(!l.sign());
+        EXPECT_TRUE(sat);
+    }
+}
+
+TEST_F(SolverTest, elimed_cls_in_memory_under_default_limit)
+{
+    s = new Solver(&conf, &must_inter);
+    const auto cls = add_easy_3sat(s, 3000, 6000);
+    const string strategy("occ-bve");
+    EXPECT_EQ(s->simplify_with_assumptions(nullptr, &strategy), l_Undef);
+
+    const ElimedClsStore& store = s->occsimplifier->elimed_store;
+    EXPECT_GT(store.size(), 1024u);
+    EXPECT_EQ(store.spilled_bytes(), 0u);
+    EXPECT_EQ(store.num_spills, 0u);
+
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    check_model(s, cls);
+}
+
+TEST_F(SolverTest, elimed_cls_spill_under_tiny_limit)
+{
+    s = new Solver(&conf, &must_inter);
+    s->occsimplifier->elimed_store.set_mem_limit(64);
+    const auto cls = add_easy_3sat(s, 3000, 6000);
+    const string strategy("occ-bve");
+    EXPECT_EQ(s->simplify_with_assumptions(nullptr, &strategy), l_Undef);
+
+    const ElimedClsStore& store = s->occsimplifier->elimed_store;
+    EXPECT_GT(store.spilled_bytes(), 0u);
+    EXPECT_GT(store.num_spills, 0u);
+
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    check_model(s, cls);
+    EXPECT_GT(store.num_spill_reads, 0u);
+}
+
+// Repeated solves under changing assumptions only re-walk the elimed clauses
+// whose inputs changed. The models must be the same as full extensions give
+TEST_F(SolverTest, extend_incremental_same_as_full)
+{
+    SolverConf conf_full;
+    conf_full.do_incremental_extend = false;
+    std::atomic<bool> must_inter_full(false);
+    Solver full(&conf_full, &must_inter_full);
+    s = new Solver(&conf, &must_inter);
+    const auto cls = add_easy_3sat(s, 3000, 6000);
+    add_easy_3sat(&full, 3000, 6000);
+    const string strategy("occ-bve");
+    for(Solver* x: {s, &full}) {
+        EXPECT_EQ(x->simplify_with_assumptions(nullptr, &strategy), l_Undef);
+        x->conf.do_simplify_problem = false;
+    }
+    ASSERT_GT(s->get_num_vars_elimed(), 1000u);
+
+    vector<uint32_t> free_vars;
+    for(uint32_t v = 0; v < 3000; v++) {
+        const uint32_t inter = s->map_outer_to_inter(v);
+        if (s->varData[inter].removed == Removed::none && s->value(inter) == l_Undef) {
+            free_vars.push_back(v);
+        }
+    }
+    ASSERT_GT(free_vars.size(), 100u);
+
+    std::mt19937 rnd(7);
+    for(uint32_t iter = 0; iter < 30; iter++) {
+        vector<Lit> assumps;
+        for(uint32_t i = 0; i < 4; i++) {
+            assumps.push_back(Lit(free_vars[rnd() % free_vars.size()], rnd() % 2));
+        }
+        //A finished solve() asks the other threads to stop
+        must_inter.store(false);
+        must_inter_full.store(false);
+        const lbool ret = s->solve_with_assumptions(&assumps);
+        ASSERT_EQ(full.solve_with_assumptions(&assumps), ret) << "iter " << iter;
+        if (ret != l_True) continue;
+        check_model(s, cls);
+        EXPECT_EQ(s->get_model(), full.get_model()) << "iter " << iter;
+    }
+
+    const auto& cache = s->occsimplifier->ext_cache;
+    EXPECT_GE(cache.num_full, 1u);
+    EXPECT_GT(cache.num_incremental, 10u);
+    EXPECT_EQ(full.occsimplifier->ext_cache.num_incremental, 0u);
+
+    //Pin the free vars to the previous model and flip one, so only that
+    //input changes and only its readers are re-walked
+    must_inter.store(false);
+    must_inter_full.store(false);
+    ASSERT_EQ(s->solve_with_assumptions(), l_True);
+    ASSERT_EQ(full.solve_with_assumptions(), l_True);
+    vector<lbool> prev_model = s->get_model();
+    uint32_t flips = 0;
+    for(uint32_t i = 0; i < free_vars.size() && flips < 10; i++) {
+        vector<Lit> assumps;
+        for(const uint32_t v: free_vars) {
+            assumps.push_back(Lit(v, prev_model[v] == l_False));
+        }
+        assumps[i] = ~assumps[i];
+        const uint64_t reextended = cache.num_reextended;
+        must_inter.store(false);
+        must_inter_full.store(false);
+        const lbool ret = s->solve_with_assumptions(&assumps);
+        ASSERT_EQ(full.solve_with_assumptions(&assumps), ret);
+        if (ret != l_True) continue;
+        flips++;
+        prev_model = s->get_model();
+        check_model(s, cls);
+        EXPECT_EQ(s->get_model(), full.get_model()) << "flip " << i;
+        EXPECT_LT(cache.num_reextended - reextended, s->occsimplifier->elimed_cls.size()/10);
+    }
+    EXPECT_EQ(flips, 10u);
+}
+
+// Offsets are scaled when the clause stack nears what they can address. The
+// addressable size is lowered here, so that a small instance needs the shift
+TEST_F(SolverTest, clause_offset_shift_raised_and_lowered)
+{
+    s = new Solver(&conf, &must_inter);
+    ClauseAllocator& alloc = s->cl_alloc;
+    alloc.max_unshifted = 1ULL << 13;
+
+    auto check_offsets = [&]() {
+        for(const ClOffset offs: s->longIrredCls) {
+            const Clause* cl = alloc.ptr(offs);
+            EXPECT_EQ(alloc.get_offset(cl), offs);
+            EXPECT_EQ(cl->size(), 4u);
+        }
+        for(uint32_t i = 0; i < s->nVars()*2; i++) {
+            const Lit lit = Lit::toLit(i);
+            for(const Watched& w: s->watches[lit]) {
+                if (!w.isClause()) continue;
+                const Clause& cl = *alloc.ptr(w.get_offset());
+                EXPECT_TRUE(cl[0] == lit || cl[1] == lit);
+            }
+        }
+    };
+
+    std::mt19937 rnd(5);
+    vector<vector<Lit>> cls;
+    s->new_vars(400);
+    while(cls.size() < 1600) {
+        for(uint32_t i = 0; i < 200; i++) {
+            vector<Lit> cl;
+            while(cl.size() < 4) {
+                const Lit l(rnd() % 400, rnd() % 2);
+                bool dup = false;
+                for(const Lit x: cl) dup |= x.var() == l.var();
+                if (!dup) cl.push_back(l);
+            }
+            s->add_clause_outside(cl);
+            cls.push_back(cl);
+        }
+        alloc.consolidate(s, true);
+        check_offsets();
+    }
+    EXPECT_GE(alloc.get_offset_shift(), 2u);
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+    check_model(s, cls);
+
+    //Far below the addressable size, the shift goes back to 0
+    alloc.max_unshifted = 1ULL << 30;
+    alloc.consolidate(s, true);
+    EXPECT_EQ(alloc.get_offset_shift(), 0u);
+    check_offsets();
+    must_inter.store(false);
+    vector<Lit> assumps = {cls[0][0]};
+    EXPECT_EQ(s->solve_with_assumptions(&assumps), l_True);
+    check_model(s, cls);
+}
+
+// The level follows the accounted memory against the budget, and only the
+// memory-hungry inprocessing steps are skipped when it is tight or over
+TEST_F(SolverTest, mem_budget_levels_and_skipping)
+{
+    s = new Solver(&conf, &must_inter);
+    s->conf.mem_budget_react_ratio = 0.5;
+    add_easy_3sat(s, 100000, 200000);
+    MemBudget& mb = *s->mem_budget;
+    const uint64_t MB = 1024ULL*1024ULL;
+    const uint64_t used = mb.used();
+    ASSERT_GT(used, 4*MB);
+
+    const vector<string> hungry = {"occ-bve", "oracle-vivif", "backbone", "sls", "card-find"};
+    const vector<string> cheap = {"sub-impl", "intree-probe", "scc-vrepl", "renumber"};
+    struct Case { uint64_t max_mem_mb; MemBudget::Level lev; };
+    const vector<Case> cases = {
+        {0, MemBudget::Level::ok},
+        {4*used/MB, MemBudget::Level::ok},
+        {used/MB + 1, MemBudget::Level::tight},
+        {used/MB/2, MemBudget::Level::over},
+        {4*used/MB, MemBudget::Level::ok},
+    };
+    for(const auto& c: cases) {
+        s->conf.max_mem_mb = c.max_mem_mb;
+        EXPECT_EQ(mb.level(), c.lev) << c.max_mem_mb;
+        mb.update();
+        const uint64_t skipped = mb.num_skipped;
+        for(const auto& t: hungry) EXPECT_EQ(mb.allows(t), c.lev == MemBudget::Level::ok) << t;
+        for(const auto& t: cheap) EXPECT_TRUE(mb.allows(t)) << t;
+        EXPECT_EQ(mb.num_skipped - skipped, c.lev == MemBudget::Level::ok ? 0 : hungry.size());
+    }
+}
+
+// Near the budget tier-2 is shrunk, but not again until it has grown. If the
+// irredundant clauses keep the memory over the budget, the checks during
+// search back off
+TEST_F(SolverTest, mem_budget_shrinks_lev2_and_backs_off)
+{
+    s = new Solver(&conf, &must_inter);
+    s->conf.mem_budget_react_ratio = 0.5;
+    add_easy_3sat(s, 100000, 200000);
+    std::mt19937 rnd(17);
+    for(uint32_t i = 0; i < 20000; i++) {
+        vector<Lit> lits;
+        for(uint32_t v = (i*7) % 99990, end = v + 5; v < end; v++) lits.push_back(Lit(v, rnd() % 2));
+        ClauseStats st;
+        st.which_red_array = 2;
+        st.glue = 2 + rnd() % 10;
+        st.activity = rnd() % 1000;
+        Clause* cl = s->add_clause_int(lits, true, &st, true);
+        ASSERT_NE(cl, nullptr);
+        s->longRedCls[2].push_back(s->cl_alloc.get_offset(cl));
+    }
+    MemBudget& mb = *s->mem_budget;
+    const uint64_t MB = 1024ULL*1024ULL;
+    s->conf.max_mem_mb = mb.used()/MB + 1;
+    ASSERT_EQ(mb.level(), MemBudget::Level::tight);
+
+    mb.check_before_inprocess();
+    const size_t after = s->longRedCls[2].size();
+    EXPECT_LT(after, 20000u*6/10);
+    EXPECT_GT(after, 0u);
+    EXPECT_EQ(mb.num_lev2_shrinks, 1u);
+
+    //Nothing new in tier-2
+    mb.check_before_inprocess();
+    EXPECT_EQ(s->longRedCls[2].size(), after);
+    EXPECT_EQ(mb.num_lev2_shrinks, 1u);
+
+    //Over the budget because of the irredundant clauses
+    s->conf.max_mem_mb = mb.used()/MB/2;
+    const uint64_t every = s->conf.mem_budget_check_every_confl;
+    for(uint64_t mult: {1, 2, 4, 8, 16, 32, 64, 64}) {
+        s->sumConflicts = mb.next_search_check;
+        mb.check_during_search();
+        EXPECT_EQ(mb.next_search_check - s->sumConflicts, every*mult);
+    }
+    EXPECT_EQ(mb.num_lev2_shrinks, 1u);
+    EXPECT_EQ(s->longRedCls[2].size(), after);
+
+    //Back to normal once memory is fine
+    s->conf.max_mem_mb = 4*mb.used()/MB;
+    for(uint64_t mult: {64, 1, 1}) {
+        s->sumConflicts = mb.next_search_check;
+        mb.check_during_search();
+        EXPECT_EQ(mb.next_search_check - s->sumConflicts, every*mult);
+    }
+}
+
+// A token that costs time without gain is skipped for 1, 2, 4 .. 16 rounds
+// and its budget shrinks down to a quarter. Gain resets the backoff and
+// grows the budget up to double
+TEST_F(SolverTest, inproc_sched_backoff_and_budget)
+{
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(10);
+    InprocSched& sch = *s->inproc_sched;
+    sch.new_round(true);
+    InprocSched::TokenStats& st = sch.tokens["distill-cls"];
+
+    const vector<uint32_t> backoffs = {1, 2, 4, 8, 16, 16};
+    const vector<double> mults = {0.5, 0.25, 0.25, 0.25, 0.25, 0.25};
+    for(size_t i = 0; i < backoffs.size(); i++) {
+        sch.update_stats(st, 1.0, 0);
+        EXPECT_EQ(st.skip_left, backoffs[i]);
+        EXPECT_DOUBLE_EQ(st.budget_mult, mults[i]);
+        for(uint32_t k = 0; k < backoffs[i]; k++) EXPECT_FALSE(sch.should_run("distill-cls"));
+        EXPECT_TRUE(sch.should_run("distill-cls"));
+    }
+    EXPECT_EQ(st.skipped, 1u+2u+4u+8u+16u+16u);
+
+    //Too short to count as a loss
+    sch.update_stats(st, 0.001, 0);
+    EXPECT_EQ(st.skip_left, 0u);
+    EXPECT_DOUBLE_EQ(st.budget_mult, 0.25);
+
+    //The budget is applied while the token runs, and restored after
+    const double mult = s->conf.global_timeout_multiplier;
+    sch.start("distill-cls");
+    EXPECT_DOUBLE_EQ(s->conf.global_timeout_multiplier, mult*0.25);
+    sch.finish("distill-cls");
+    EXPECT_DOUBLE_EQ(s->conf.global_timeout_multiplier, mult);
+
+    sch.update_stats(st, 1.0, 0.1);
+    EXPECT_EQ(st.backoff, 0u);
+    EXPECT_EQ(st.skip_left, 0u);
+    EXPECT_DOUBLE_EQ(st.budget_mult, 0.25*1.2);
+    for(uint32_t i = 0; i < 20; i++) sch.update_stats(st, 1.0, 0.1);
+    EXPECT_DOUBLE_EQ(st.budget_mult, 2.0);
+
+    //Not adaptive, nothing is skipped
+    sch.update_stats(st, 1.0, 0);
+    sch.new_round(false);
+    EXPECT_TRUE(sch.should_run("distill-cls"));
+    EXPECT_EQ(st.skip_left, 1u);
+
+    //Over the time ratio, only the ones paying off above average run
+    sch.new_round(true);
+    st.skip_left = 0;
+    sch.tokens["sub-impl"].runs = 1;
+    sch.tokens["sub-impl"].rate = 2*st.rate + 1;
+    sch.total_time = 1e9;
+    EXPECT_FALSE(sch.should_run("distill-cls"));
+    EXPECT_TRUE(sch.should_run("sub-impl"));
+}
+
+// Tokens that don't remove vars or irredundant literals always run, with
+// the normal budget
+TEST_F(SolverTest, inproc_sched_exempt_tokens)
+{
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(10);
+    InprocSched& sch = *s->inproc_sched;
+    sch.new_round(true);
+    const double mult = s->conf.global_timeout_multiplier;
+    for(const string token: {"louvain-comms", "sls", "card-find", "breakid", "lucky"}) {
+        for(uint32_t i = 0; i < 5; i++) {
+            EXPECT_TRUE(sch.should_run(token));
+            sch.start(token);
+            EXPECT_DOUBLE_EQ(s->conf.global_timeout_multiplier, mult);
+            const double t0 = cpuTime();
+            while(cpuTime() - t0 < 0.02) {}
+            sch.finish(token);
+        }
+        const InprocSched::TokenStats& st = sch.tokens[token];
+        EXPECT_EQ(st.runs, 5u);
+        EXPECT_EQ(st.skip_left, 0u);
+        EXPECT_DOUBLE_EQ(st.budget_mult, 1.0);
+    }
+    sch.total_time = 1e9;
+    EXPECT_TRUE(sch.should_run("sls"));
+}
+
+// Backbone with the solver's own search, on small random 3-SAT instances
+// near the threshold, whose backbone is computed by enumerating all
+// assignments. The user's assumptions, model and final conflict must be
+// the same afterwards.
+TEST(backbone, own_search_finds_backbone)
+{
+    const uint32_t nvars = 16;
+    uint32_t tested = 0;
+    for(uint32_t seed = 0; tested < 5; seed++) {
+        ASSERT_LT(seed, 500u);
+        std::mt19937 rnd(seed);
+        vector<vector<Lit>> cls;
+        for(uint32_t i = 0; i < 66; i++) {
+            vector<Lit> cl;
+            while(cl.size() < 3) {
+                const Lit l(rnd() % nvars, rnd() % 2);
+                bool dup = false;
+                for(const Lit x: cl) dup |= x.var() == l.var();
+                if (!dup) cl.push_back(l);
+            }
+            cls.push_back(cl);
+        }
+
+        //Backbone by enumeration: bit 0 of seen_val[v] is set if v is
+        //false in some model, bit 1 if it is true in some model
+        vector<uint32_t> seen_val(nvars, 0);
+        uint32_t num_models = 0;
+        for(uint32_t m = 0; m < (1U << nvars); m++) {
+            bool sat = true;
+            for(const auto& cl: cls) {
+                bool cl_sat = false;
+                for(const Lit l: cl) cl_sat |= (bool)((m >> l.var()) & 1) != l.sign();
+                if (!cl_sat) {sat = false; break;}
+            }
+            if (!sat) continue;
+            num_models++;
+            for(uint32_t v = 0; v < nvars; v++) seen_val[v] |= 1U << ((m >> v) & 1);
+        }
+        vector<Lit> backbone;
+        for(uint32_t v = 0; v < nvars; v++) {
+            if (seen_val[v] == 1) backbone.push_back(Lit(v, true));
+            if (seen_val[v] == 2) backbone.push_back(Lit(v, false));
+        }
+        if (num_models < 2 || backbone.size() < 3 || backbone.size() > nvars-3) continue;
+        tested++;
+
+        SolverConf conf;
+        conf.do_simplify_problem = false;
+        std::atomic<bool> must_inter(false);
+        Solver s(&conf, &must_inter);
+        s.new_vars(nvars);
+        for(const auto& cl: cls) s.add_clause_outside(cl);
+
+        //A model, then a final conflict, left by the user's calls
+        ASSERT_EQ(s.solve_with_assumptions(), l_True);
+        must_inter.store(false);
+        vector<Lit> assumps = {~backbone[0]};
+        ASSERT_EQ(s.solve_with_assumptions(&assumps), l_False);
+        const vector<lbool> model = s.get_model();
+        const vector<Lit> conflict = s.get_final_conflict();
+        EXPECT_FALSE(model.empty());
+        EXPECT_FALSE(conflict.empty());
+
+        //As if called while solving under these assumptions
+        uint32_t non_bb = 0;
+        while(std::find(backbone.begin(), backbone.end(), Lit(non_bb, false)) != backbone.end()
+            || std::find(backbone.begin(), backbone.end(), Lit(non_bb, true)) != backbone.end()) non_bb++;
+        s.assumptions = {Lit(non_bb, true)};
+        s.varData[non_bb].assumption = l_False;
+
+        must_inter.store(false);
+        bool finished = false;
+        EXPECT_TRUE(s.backbone_simpl(100000, finished));
+        EXPECT_TRUE(finished);
+
+        vector<Lit> units = s.get_zero_assigned_lits();
+        std::sort(units.begin(), units.end());
+        std::sort(backbone.begin(), backbone.end());
+        EXPECT_EQ(units, backbone) << "seed " << seed;
+
+        EXPECT_EQ(s.assumptions, vector<Lit>{Lit(non_bb, true)});
+        for(uint32_t v = 0; v < nvars; v++) {
+            EXPECT_EQ(s.varData[v].assumption, v == non_bb ? l_False : l_Undef);
+        }
+        EXPECT_EQ(s.get_model(), model);
+        EXPECT_EQ(s.get_final_conflict(), conflict);
+    }
+}
+
+// The tier-2 clean picks the clauses to keep with nth_element. It must keep
+// as many clauses, with the same keys, as sorting the whole tier did.
+// Activities are all different, so that selection must be exactly the same
+TEST_F(SolverTest, lev2_marks_same_as_sort)
+{
+    s = new Solver(&conf, &must_inter);
+    s->new_vars(100);
+    std::mt19937 rnd(13);
+    vector<double> acts(3000);
+    for(uint32_t i = 0; i < acts.size(); i++) acts[i] = 1.0 + i*0.5;
+    std::shuffle(acts.begin(), acts.end(), rnd);
+    for(uint32_t i = 0; i < acts.size(); i++) {
+        vector<Lit> lits;
+        for(uint32_t v = i % 90, end = v + 4; v < end; v++) lits.push_back(Lit(v, rnd() % 2));
+        ClauseStats st;
+        st.which_red_array = 2;
+        st.glue = 2 + rnd() % 10;
+        st.activity = acts[i];
+        st.ttl = i % 13 == 0;
+        Clause* cl = s->add_clause_int(lits, true, &st, true);
+        ASSERT_NE(cl, nullptr);
+        s->longRedCls[2].push_back(s->cl_alloc.get_offset(cl));
+    }
+
+    auto marked = [&]() {
+        vector<ClOffset> ret;
+        for(const ClOffset offs: s->longRedCls[2]) {
+            Clause* cl = s->cl_alloc.ptr(offs);
+            if (cl->stats.marked_clause) ret.push_back(offs);
+            cl->stats.marked_clause = false;
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+    //What the old code did: sort the whole tier, mark the first keep_num
+    //markable clauses
+    auto sort_and_mark = [&](const ClauseClean type, const uint64_t keep_num) {
+        vector<ClOffset> offs = s->longRedCls[2];
+        std::sort(offs.begin(), offs.end(), [&](const ClOffset a, const ClOffset b) {
+            const Clause* x = s->cl_alloc.ptr(a);
+            const Clause* y = s->cl_alloc.ptr(b);
+            if (type == ClauseClean::glue) return x->stats.glue < y->stats.glue;
+            return x->stats.activity > y->stats.activity;
+        });
+        uint64_t num = 0;
+        for(size_t i = 0; i < offs.size() && num < keep_num; i++) {
+            Clause* cl = s->cl_alloc.ptr(offs[i]);
+            if (cl->stats.ttl > 0 || cl->stats.marked_clause) continue;
+            cl->stats.marked_clause = true;
+            num++;
+        }
+    };
+    auto glues = [&](const vector<ClOffset>& offs) {
+        vector<uint32_t> ret;
+        for(const ClOffset o: offs) ret.push_back(s->cl_alloc.ptr(o)->stats.glue);
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+
+    for(const uint64_t keep_num: {0U, 1U, 100U, 1500U, 2800U, 5000U}) {
+        s->reduceDB->mark_top_N_clauses_lev2(ClauseClean::activity, keep_num);
+        const auto sel = marked();
+        sort_and_mark(ClauseClean::activity, keep_num);
+        EXPECT_EQ(sel, marked());
+
+        s->reduceDB->mark_top_N_clauses_lev2(ClauseClean::glue, keep_num);
+        const auto sel_glue = marked();
+        sort_and_mark(ClauseClean::glue, keep_num);
+        const auto sorted_glue = marked();
+        EXPECT_EQ(sel_glue.size(), sorted_glue.size());
+        EXPECT_EQ(glues(sel_glue), glues(sorted_glue));
+
+        //Both passes, the second one skips the clauses the first marked
+        s->reduceDB->mark_top_N_clauses_lev2(ClauseClean::glue, keep_num/2);
+        s->reduceDB->mark_top_N_clauses_lev2(ClauseClean::activity, keep_num/2);
+        const auto both = marked();
+        sort_and_mark(ClauseClean::glue, keep_num/2);
+        sort_and_mark(ClauseClean::activity, keep_num/2);
+        EXPECT_EQ(both.size(), marked().size());
+    }
+}
+
+// updateArray() permutes in place by following cycles. It must give the
+// same result as gathering from a copy
+TEST(varupdate, updateArray_same_as_copy)
+{
+    std::mt19937 rnd(11);
+    for(const uint32_t sz: {0U, 1U, 2U, 3U, 17U, 1000U}) {
+        for(uint32_t iter = 0; iter < 20; iter++) {
+            vector<uint32_t> mapper(sz);
+            for(uint32_t i = 0; i < sz; i++) mapper[i] = i;
+            std::shuffle(mapper.begin(), mapper.end(), rnd);
+            //Extra entries past the array's size are allowed and ignored
+            if (iter % 2) mapper.push_back(sz + 5);
+
+            vector<uint32_t> nums(sz);
+            vector<std::string> strs(sz);
+            for(uint32_t i = 0; i < sz; i++) {
+                nums[i] = rnd();
+                strs[i] = std::to_string(nums[i]) + "-long-enough-to-be-on-the-heap";
+            }
+
+            vector<uint32_t> nums_copy(sz);
+            vector<std::string> strs_copy(sz);
+            for(uint32_t i = 0; i < sz; i++) {
+                nums_copy[i] = nums.at(mapper.at(i));
+                strs_copy[i] = strs.at(mapper.at(i));
+            }
+
+            updateArray(nums, mapper);
+            updateArray(strs, mapper);
+            EXPECT_EQ(nums, nums_copy);
+            EXPECT_EQ(strs, strs_copy);
+        }
+    }
+}
+
+// Renumbering must keep the VMTF queue in the same order, just with the
+// variables' new numbers. The queue still holds the variables moved past
+// nVars(), it is only rebuilt from the timestamps when searching again
+TEST_F(SolverTest, renumber_keeps_vmtf_order)
+{
+    conf.do_simplify_problem = false;
+    s = new Solver(&conf, &must_inter);
+    add_easy_3sat(s, 300, 600);
+    ASSERT_EQ(s->solve_with_assumptions(), l_True);
+
+    //Level-0 assigned variables are moved to the end when renumbering
+    const vector<lbool> model = s->get_model();
+    for(uint32_t v = 0; v < 300; v += 7) s->add_clause_outside({Lit(v, model[v] == l_False)});
+    ASSERT_TRUE(s->okay());
+
+    //Mix up the queue so that it is not in variable order
+    std::mt19937 rnd(7);
+    for(uint32_t i = 0; i < 500; i++) s->vmtf_bump_queue(rnd() % 300);
+
+    auto outer_queue = [&]() {
+        vector<uint32_t> order;
+        uint32_t prev = numeric_limits<uint32_t>::max();
+        for(uint32_t v = s->vmtf_queue.first; v != numeric_limits<uint32_t>::max()
+            ; v = s->vmtf_links[v].next
+        ) {
+            EXPECT_EQ(s->vmtf_links[v].prev, prev);
+            order.push_back(s->map_inter_to_outer(v));
+            prev = v;
+            if (order.size() > s->nVarsOuter()) break;
+        }
+        EXPECT_EQ(s->vmtf_queue.last, prev);
+        return order;
+    };
+    auto outer_btab = [&]() {
+        vector<uint64_t> btab(s->nVarsOuter());
+        for(uint32_t v = 0; v < s->nVarsOuter(); v++) btab[s->map_inter_to_outer(v)] = s->vmtf_btab[v];
+        return btab;
+    };
+
+    const vector<uint32_t> order = outer_queue();
+    const vector<uint64_t> btab = outer_btab();
+    const uint32_t unassigned = s->map_inter_to_outer(s->vmtf_queue.unassigned);
+    EXPECT_EQ(order.size(), 300u);
+
+    ASSERT_TRUE(s->renumber_variables(true));
+    bool moved = false;
+    for(uint32_t v = 0; v < s->nVarsOuter(); v++) moved |= s->map_inter_to_outer(v) != v;
+    ASSERT_TRUE(moved);
+
+    EXPECT_EQ(outer_queue(), order);
+    EXPECT_EQ(outer_btab(), btab);
+    EXPECT_EQ(s->map_inter_to_outer(s->vmtf_queue.unassigned), unassigned);
+    must_inter.store(false);
+    EXPECT_EQ(s->solve_with_assumptions(), l_True);
+}
+
+// The bit-parallel filter of bin-only probing must let through every
+// variable that probing learns from: failed literals in both polarities,
+// literals implied by both polarities and equivalences. Implication chains
+// have nothing to learn, so they must be filtered out.
+TEST(full_probe, bit_filter_same_as_unfiltered)
+{
+    const uint32_t gadgets = 20;
+    const uint32_t chain_len = 10;
+
+    struct Result {
+        vector<Lit> units;
+        uint64_t irred_bins;
+        uint64_t filtered;
+    };
+    auto run = [&](const bool bits) {
+        SolverConf conf;
+        conf.bit_parallel_probe = bits;
+        conf.verbosity = 1;
+        std::atomic<bool> must_inter(false);
+        Solver s(&conf, &must_inter);
+        s.new_vars(gadgets*(2 + 2 + 4 + chain_len));
+        uint32_t v = 0;
+        for(uint32_t i = 0; i < gadgets; i++, v += 2) {
+            //v or ~v implies both w and ~w
+            const Lit a(v, i % 2);
+            const Lit b(v+1, false);
+            s.add_clause_outside({~a, b});
+            s.add_clause_outside({~a, ~b});
+        }
+        for(uint32_t i = 0; i < gadgets; i++, v += 2) {
+            //w is implied by both v and ~v
+            s.add_clause_outside({Lit(v, true), Lit(v+1, false)});
+            s.add_clause_outside({Lit(v, false), Lit(v+1, false)});
+        }
+        for(uint32_t i = 0; i < gadgets; i++, v += 4) {
+            //v -> v+1 -> v+2 and ~v -> v+3 -> ~(v+2), so v == v+2
+            s.add_clause_outside({Lit(v, true), Lit(v+1, false)});
+            s.add_clause_outside({Lit(v+1, true), Lit(v+2, false)});
+            s.add_clause_outside({Lit(v, false), Lit(v+3, false)});
+            s.add_clause_outside({Lit(v+3, true), Lit(v+2, true)});
+        }
+        for(uint32_t i = 0; i < gadgets; i++, v += chain_len) {
+            for(uint32_t k = 0; k+1 < chain_len; k++) {
+                s.add_clause_outside({Lit(v+k, true), Lit(v+k+1, false)});
+            }
+        }
+        assert(v == s.nVars());
+
+        Result r;
+        const uint64_t bins_before = s.binTri.irredBins;
+        testing::internal::CaptureStdout();
+        EXPECT_TRUE(s.full_probe(true));
+        const string out = testing::internal::GetCapturedStdout();
+        r.units = s.get_zero_assigned_lits();
+        std::sort(r.units.begin(), r.units.end());
+        r.irred_bins = s.binTri.irredBins - bins_before;
+
+        const size_t at = out.find("filtered: ");
+        EXPECT_NE(at, string::npos);
+        r.filtered = std::stoull(out.substr(at + 10));
+        return r;
+    };
+
+    const Result with = run(true);
+    const Result without = run(false);
+    EXPECT_EQ(with.units, without.units);
+    EXPECT_EQ(with.irred_bins, without.irred_bins);
+    EXPECT_EQ(without.filtered, 0u);
+    EXPECT_GE(with.filtered, gadgets*chain_len);
+
+    vector<Lit> expected;
+    for(uint32_t i = 0; i < gadgets; i++) expected.push_back(Lit(2*i, i % 2 == 0));
+    for(uint32_t i = 0; i < gadgets; i++) expected.push_back(Lit(gadgets*2 + 2*i + 1, false));
+    for(const Lit l: expected) {
+        EXPECT_TRUE(std::binary_search(with.units.begin(), with.units.end(), l)) << l;
+    }
+    EXPECT_EQ(with.units.size(), expected.size());
+    //Every equivalence is added as a pair of binaries
+    EXPECT_GE(with.irred_bins, gadgets*2);
+}
+
+// Over 1M irred literals the features are computed on every 2nd clause only.
+// Most variables occur in a single clause, so many of them are not in the
+// sample, but they must still be counted
+TEST(satzilla, sampled_features_count_all_vars)
+{
+    SolverConf conf_full;
+    conf_full.satzilla_sample_litsM = 0;
+    SolverConf conf_sampled;
+    conf_sampled.satzilla_sample_litsM = 1;
+    std::atomic<bool> must_inter(false);
+    Solver full(&conf_full, &must_inter);
+    Solver sampled(&conf_sampled, &must_inter);
+    add_easy_3sat(&full, 1000000, 400000);
+    add_easy_3sat(&sampled, 1000000, 400000);
+
+    const SatZillaFeatures f = full.calculate_satzilla_features();
+    const SatZillaFeatures g = sampled.calculate_satzilla_features();
+    EXPECT_GT(f.numVars, 600000);
+    EXPECT_EQ(g.numVars, f.numVars);
+    EXPECT_EQ(g.numClauses, f.numClauses);
+    EXPECT_DOUBLE_EQ(g.var_cl_ratio, f.var_cl_ratio);
+    EXPECT_NEAR(g.vcg_var_mean, f.vcg_var_mean, f.vcg_var_mean*0.01);
+    EXPECT_NEAR(g.vcg_cls_mean, f.vcg_cls_mean, f.vcg_cls_mean*0.01);
+    EXPECT_NEAR(g.pnr_cls_mean, f.pnr_cls_mean, 0.01);
+}
+
+// With sampling off, the clause distributions are over every clause
+TEST(satzilla, no_sampling_uses_all_clauses)
+{
+    SolverConf conf_off;
+    conf_off.satzilla_sample_litsM = 0;
+    SolverConf conf_large;
+    conf_large.satzilla_sample_litsM = 1000;
+    std::atomic<bool> must_inter(false);
+    Solver off(&conf_off, &must_inter);
+    Solver large(&conf_large, &must_inter);
+
+    std::mt19937 rnd(9);
+    off.new_vars(200);
+    large.new_vars(200);
+    for(uint32_t i = 0; i < 500; i++) {
+        vector<Lit> cl;
+        for(uint32_t v = i % 190, end = v + 3 + i % 5; v < end; v++) cl.push_back(Lit(v, rnd() % 2));
+        off.add_clause_outside(cl);
+        large.add_clause_outside(cl);
+    }
+
+    const SatZillaFeatures f = off.calculate_satzilla_features();
+    const SatZillaFeatures g = large.calculate_satzilla_features();
+    EXPECT_DOUBLE_EQ(f.irred_cl_distrib.size_distr_mean, g.irred_cl_distrib.size_distr_mean);
+    EXPECT_DOUBLE_EQ(f.irred_cl_distrib.size_distr_var, g.irred_cl_distrib.size_distr_var);
+    EXPECT_GT(f.irred_cl_distrib.size_distr_var, 0);
+}
+
+// Long clauses learnt by s1 are imported by s2 through SharedData. The
+// buffer limit is tiny, so trim_shared_longs() drops the oldest clauses
+// between s2's syncs
+// Which preset each reconf heuristic picks, and the order the threads take
+TEST(reconf, heuristics_pick_presets)
+{
+    SatZillaFeatures f;
+    EXPECT_EQ(get_reconf_ranking(f, 0), (vector<int>{0, 4, 8}));
+
+    SatZillaFeatures xors;
+    xors.num_xors_found_last = 3;
+    EXPECT_EQ(get_reconf_from_satzilla_features(xors, 0), 0);
+
+    SatZillaFeatures bins;
+    bins.binary = 0.7;
+    EXPECT_EQ(get_reconf_ranking(bins, 0), (vector<int>{4, 0, 8}));
+
+    SatZillaFeatures large;
+    large.numClauses = 3000000;
+    EXPECT_EQ(get_reconf_ranking(large, 0), (vector<int>{8, 0, 4}));
+
+    //XORs or BNNs win over the other two rules
+    SatZillaFeatures bnn_bins_large = large;
+    bnn_bins_large.num_bnns = 1;
+    bnn_bins_large.binary = 0.7;
+    EXPECT_EQ(get_reconf_ranking(bnn_bins_large, 0), (vector<int>{0, 4, 8}));
+
+    //Mostly binary wins over large
+    SatZillaFeatures bins_large = large;
+    bins_large.binary = 0.7;
+    EXPECT_EQ(get_reconf_ranking(bins_large, 0), (vector<int>{4, 8, 0}));
+}
+
+TEST(share_long, imported_after_trim_are_attached)
+{
+    SolverConf conf;
+    conf.sync_every_confl = 0;
+    conf.share_long_lits_limit_K = 1;
+    std::atomic<bool> must_inter(false);
+    SharedData shared(2);
+    Solver s1(&conf, &must_inter);
+    Solver s2(&conf, &must_inter);
+    s1.set_shared_data(&shared);
+    s2.set_shared_data(&shared);
+    const uint32_t vars = 200;
+    s1.new_vars(vars);
+    s2.new_vars(vars);
+
+    std::mt19937 rnd(1);
+    set<vector<Lit>> sent;
+    vector<vector<Lit>> last_batch;
+    for(uint32_t batch = 0; batch < 6; batch++) {
+        last_batch.clear();
+        for(uint32_t i = 0; i < 100; i++) {
+            vector<Lit> cl;
+            const uint32_t sz = 3 + rnd() % 3;
+            while(cl.size() < sz) {
+                const Lit l(rnd() % vars, rnd() % 2);
+                bool dup = false;
+                for(const Lit x: cl) dup |= x.var() == l.var();
+                if (!dup) cl.push_back(l);
+            }
+            s1.datasync->signal_new_long_clause(cl, 2);
+            std::sort(cl.begin(), cl.end());
+            sent.insert(cl);
+            last_batch.push_back(cl);
+        }
+        s1.sumConflicts++;
+        EXPECT_TRUE(s1.datasync->syncData());
+        //s2 falls behind every other batch, so it gets lapped by the trims
+        if (batch % 2 == 1) {
+            s2.sumConflicts++;
+            EXPECT_TRUE(s2.datasync->syncData());
+        }
+    }
+    EXPECT_GT(shared.long_base, 0u);
+    EXPECT_LE(shared.longs.size(), conf.share_long_lits_limit_K*1000ULL);
+
+    s2.find_all_attached(s2.longRedCls[2]);
+    set<vector<Lit>> got;
+    for(const ClOffset off: s2.longRedCls[2]) {
+        const Clause& cl = *s2.cl_alloc.ptr(off);
+        EXPECT_TRUE(cl.red());
+        vector<Lit> lits(cl.begin(), cl.end());
+        std::sort(lits.begin(), lits.end());
+        EXPECT_TRUE(sent.count(lits)) << "imported clause was never sent";
+        EXPECT_TRUE(got.insert(lits).second) << "imported twice";
+    }
+    EXPECT_EQ(got.size(), s2.datasync->get_stats().recvLongData);
+    EXPECT_LT(got.size(), sent.size());
+    for(const auto& cl: last_batch) EXPECT_TRUE(got.count(cl));
+    EXPECT_EQ(s1.longRedCls[2].size(), 0u);
+}
+
+// Real threads with the same tiny buffer, so trims happen while solving
+static lbool solve_threaded_php(const uint32_t pigeons, const uint32_t holes)
+{
+    SolverConf conf;
+    conf.sync_every_confl = 100;
+    conf.share_long_lits_limit_K = 1;
+    SATSolver s(&conf);
+    s.set_num_threads(4);
+    s.new_vars(pigeons*holes);
+    auto v = [&](uint32_t p, uint32_t h) {return Lit(p*holes+h, false);};
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) cl.push_back(v(p, h));
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{~v(p1, h), ~v(p2, h)});
+            }
+        }
+    }
+    const lbool ret = s.solve();
+    if (ret == l_True) {
+        for(uint32_t h = 0; h < holes; h++) {
+            uint32_t in_hole = 0;
+            for(uint32_t p = 0; p < pigeons; p++) in_hole += s.get_model()[v(p, h).var()] == l_True;
+            EXPECT_LE(in_hole, 1u);
+        }
+    }
+    return ret;
+}
+
+TEST(share_long, threads_php)
+{
+    EXPECT_EQ(solve_threaded_php(8, 7), l_False);
+    EXPECT_EQ(solve_threaded_php(8, 8), l_True);
+}
+
+// Several XOR systems over disjoint variables, each in its own Gauss-Jordan
+// matrix. The number of solutions must be the product of the brute-force
+// counts of the blocks, and an inconsistent block must make it UNSAT
+static uint64_t count_multi_matrix_sols(const uint32_t seed, const bool make_unsat,
+    uint64_t& expected, uint32_t& num_matrices, uint64_t& gauss_hits)
+{
+    const uint32_t blocks = 4;
+    const uint32_t per_block = 6;
+    std::mt19937 mtrand(seed);
+    SolverConf conf;
+    conf.gaussconf.autodisable = false;
+    conf.gaussconf.min_matrix_rows = 2;
+    std::atomic<bool> must_inter(false);
+    Solver s(&conf, &must_inter);
+    s.new_vars(blocks*per_block);
+
+    expected = 1;
+    for(uint32_t b = 0; b < blocks; b++) {
+        vector<std::pair<vector<uint32_t>, bool>> xors;
+        for(uint32_t k = 0; k < 4; k++) {
+            vector<uint32_t> vs;
+            for(uint32_t v = 0; v < per_block; v++) {
+                if (mtrand() % 2) vs.push_back(b*per_block + v);
+            }
+            if (vs.size() < 3) vs = {b*per_block, b*per_block+1+k%3, b*per_block+4+k%2};
+            xors.push_back(std::make_pair(vs, mtrand() % 2));
+        }
+        if (make_unsat && b == blocks-1) {
+            //Sum of the first two, with the opposite rhs
+            vector<char> in(blocks*per_block, 0);
+            for(const auto& x: {xors[0], xors[1]}) for(uint32_t v: x.first) in[v] ^= 1;
+            vector<uint32_t> vs;
+            for(uint32_t v = 0; v < in.size(); v++) if (in[v]) vs.push_back(v);
+            if (vs.empty()) xors.push_back(std::make_pair(xors[0].first, !xors[0].second));
+            else xors.push_back(std::make_pair(vs, !(xors[0].second ^ xors[1].second)));
+        }
+
+        uint64_t block_sols = 0;
+        for(uint32_t val = 0; val < (1U << per_block); val++) {
+            bool ok = true;
+            for(const auto& x: xors) {
+                bool rhs = false;
+                for(uint32_t v: x.first) rhs ^= (val >> (v - b*per_block)) & 1;
+                ok &= rhs == x.second;
+            }
+            block_sols += ok;
+        }
+        expected *= block_sols;
+        for(const auto& x: xors) s.add_xor_clause_outside(x.first, x.second);
+    }
+
+    uint64_t sols = 0;
+    while(true) {
+        must_inter.store(false, std::memory_order_relaxed);
+        if (s.solve_with_assumptions() != l_True) break;
+        sols++;
+        vector<Lit> block;
+        for(uint32_t v = 0; v < blocks*per_block; v++) {
+            block.push_back(Lit(v, s.get_model()[v] == l_True));
+        }
+        s.add_clause_outside(block);
+        if (sols > expected) break;
+    }
+    num_matrices = std::max<uint32_t>(num_matrices, s.gmatrices.size());
+    for(const auto& gqd: s.gqueuedata) gauss_hits += gqd.num_props + gqd.num_conflicts;
+    return sols;
+}
+
+TEST(gauss, multi_matrix_same_sols)
+{
+    uint32_t num_matrices = 0;
+    uint64_t gauss_hits = 0;
+    for(uint32_t seed = 1; seed <= 20; seed++) {
+        for(const bool make_unsat: {false, true}) {
+            uint64_t expected;
+            const uint64_t sols = count_multi_matrix_sols(
+                seed, make_unsat, expected, num_matrices, gauss_hits);
+            EXPECT_EQ(sols, expected) << "seed: " << seed << " unsat: " << make_unsat;
+            if (make_unsat) EXPECT_EQ(sols, 0u);
+        }
+    }
+    EXPECT_GE(num_matrices, 2u);
+    EXPECT_GT(gauss_hits, 0u);
+}
+
+// BreakID's aux vars would only be made by one thread, whether or not it is
+// compiled in
+TEST(breakid, rejected_with_threads)
+{
+    SolverConf conf;
+    conf.doBreakid = true;
+    SATSolver s(&conf);
+    EXPECT_THROW(s.set_num_threads(4), std::runtime_error);
+    s.set_num_threads(1);
+    s.new_vars(2);
+    s.add_clause(str_to_cl("1, 2"));
+    EXPECT_EQ(s.solve(), l_True);
+}
 }
 
 int main(int argc, char **argv) {